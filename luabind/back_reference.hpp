@@ -32,6 +32,7 @@
 #endif
 
 #include <luabind/pointer_traits.hpp>
+#include <luabind/detail/state_context.hpp>
 
 namespace luabind {
 	struct wrap_base;
@@ -39,39 +40,46 @@ namespace luabind {
 	namespace detail
 	{
 		template<class T>
-		wrap_base const* get_back_reference_aux0(T const* p, std::true_type)
+		wrap_base const* get_back_reference_aux0(lua_State* L, T const* p, std::true_type)
 		{
+			if(!p)
+				return 0;
+
+			// Objects of a class registered without a wrapper are not cast.
+			state_context& context = get_state_context(L);
+			if(!context.may_be_wrapped(get_dynamic_class(context, p).first))
+				return 0;
 			return dynamic_cast<wrap_base const*>(p);
 		}
 
 		template<class T>
-		wrap_base const* get_back_reference_aux0(T const*, std::false_type)
+		wrap_base const* get_back_reference_aux0(lua_State*, T const*, std::false_type)
 		{
 			return 0;
 		}
 
 		template<class T>
-		wrap_base const* get_back_reference_aux1(T const* p)
+		wrap_base const* get_back_reference_aux1(lua_State* L, T const* p)
 		{
-			return get_back_reference_aux0(p, std::is_polymorphic<T>());
+			return get_back_reference_aux0(L, p, std::is_polymorphic<T>());
 		}
 
 		template<class T>
-		wrap_base const* get_back_reference_aux2(T const& x, std::true_type)
+		wrap_base const* get_back_reference_aux2(lua_State* L, T const& x, std::true_type)
 		{
-			return get_back_reference_aux1(get_pointer(x));
+			return get_back_reference_aux1(L, get_pointer(x));
 		}
 
 		template<class T>
-		wrap_base const* get_back_reference_aux2(T const& x, std::false_type)
+		wrap_base const* get_back_reference_aux2(lua_State* L, T const& x, std::false_type)
 		{
-			return get_back_reference_aux1(&x);
+			return get_back_reference_aux1(L, &x);
 		}
 
 		template<class T>
-		wrap_base const* get_back_reference(T const& x)
+		wrap_base const* get_back_reference(lua_State* L, T const& x)
 		{
-			return detail::get_back_reference_aux2(x, has_get_pointer<T>());
+			return detail::get_back_reference_aux2(L, x, has_get_pointer<T>());
 		}
 
 	} // namespace detail
@@ -80,7 +88,7 @@ namespace luabind {
 	bool get_back_reference(lua_State* L, T const& x)
 	{
 #ifndef LUABIND_NO_RTTI
-		if(wrap_base const* w = detail::get_back_reference(x))
+		if(wrap_base const* w = detail::get_back_reference(L, x))
 		{
 			detail::wrap_access::ref(*w).get(L);
 			return true;
@@ -93,7 +101,7 @@ namespace luabind {
 	bool move_back_reference(lua_State* L, T const& x)
 	{
 #ifndef LUABIND_NO_RTTI
-		if(wrap_base* w = const_cast<wrap_base*>(detail::get_back_reference(x)))
+		if(wrap_base* w = const_cast<wrap_base*>(detail::get_back_reference(L, x)))
 		{
 			assert(detail::wrap_access::ref(*w).m_strong_ref.is_valid());
 			detail::wrap_access::ref(*w).get(L);
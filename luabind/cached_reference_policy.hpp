@@ -0,0 +1,58 @@
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef LUABIND_CACHED_REFERENCE_POLICY_HPP_INCLUDED
+# define LUABIND_CACHED_REFERENCE_POLICY_HPP_INCLUDED
+
+# include <type_traits>
+# include <luabind/detail/policy.hpp>
+# include <luabind/detail/object_rep.hpp>
+
+namespace luabind {
+	namespace detail {
+
+		// Pushes a reference into the object in stack slot 1, the instance
+		// the member or function was looked up on, reusing the instance
+		// created for the same reference the last time if it is still alive.
+		struct cached_reference_converter
+		{
+			template <class T>
+			void to_lua(lua_State* L, T& x)
+			{
+				object_rep* parent = get_instance(L, 1);
+
+				if(parent && parent->get_child(L, &x, registered_class<T>::id, std::is_const<T>::value))
+					return;
+
+				default_converter<T&>().to_lua(L, x);
+
+				if(!parent)
+					return;
+
+				if(object_rep* child = get_instance(L, -1))
+				{
+					child->add_dependency(L, 1);
+					parent->add_child(L, &x, -1);
+				}
+			}
+		};
+
+		struct cached_reference_policy
+		{
+			template <class T, class Direction>
+			struct specialize
+			{
+				static_assert(std::is_same<Direction, cpp_to_lua>::value, "Cached reference policy only supports cpp -> lua");
+				using type = cached_reference_converter;
+			};
+		};
+
+	} // namespace detail
+
+	// Caution: If we use the aliased type "policy_list" here, MSVC crashes.
+	using cached_reference = meta::type_list<converter_policy_injector<0, detail::cached_reference_policy>>;
+
+} // namespace luabind
+
+#endif // LUABIND_CACHED_REFERENCE_POLICY_HPP_INCLUDED
@@ -94,6 +94,7 @@
 #include <luabind/detail/inheritance.hpp>
 #include <luabind/detail/signature_match.hpp>
 #include <luabind/no_dependency.hpp>
+#include <luabind/cached_reference_policy.hpp>
 #include <luabind/typeid.hpp>
 #include <luabind/detail/meta.hpp>
 
@@ -118,6 +119,10 @@ namespace luabind {
 	using no_bases = bases< >;
 	using default_holder = null_type;
 
+	// Passed as the holder type, constructs the objects created from Lua
+	// inside their instance userdata. Such objects cannot be adopted by C++.
+	struct held_by_value {};
+
 	namespace detail {
 
 		template < typename T >
@@ -246,11 +251,17 @@ namespace luabind {
 
 			const char* name() const;
 
-			void add_static_constant(const char* name, int val);
+			void add_static_constant(const char* name, enum_value_type val);
 			void add_inner_scope(scope& s);
 
 			void add_cast(class_id src, class_id target, cast_function cast);
 
+			// Makes instances constructed from Lua big enough for the holder.
+			void add_holder_size(std::size_t size);
+
+			void add_slot(char const* name);
+			void add_identity_map();
+
 		private:
 			class_registration* m_registration;
 		};
@@ -296,16 +307,32 @@ namespace luabind {
 			using type = std::unique_ptr<T>;
 		};
 
+		template <class Class, class Pointer, class Signature>
+		struct constructor_type
+		{
+			using type = construct<Class, typename default_pointer<Pointer, Class>::type, Signature>;
+		};
+
+		template <class Class, class Signature>
+		struct constructor_type<Class, held_by_value, Signature>
+		{
+			static_assert(!std::is_base_of<wrap_base, Class>::value,
+				"wrapped classes must be held by pointer, to hand their ownership over to C++");
+
+			using type = construct_in_place<Class, Signature>;
+		};
+
 		template <class Class, class Pointer, class Signature, class Policies>
 		struct constructor_registration : registration
 		{
+			using construct_type = typename constructor_type<Class, Pointer, Signature>::type;
+
 			constructor_registration()
 			{}
 
 			void register_(lua_State* L) const
 			{
-				using pointer = typename default_pointer<Pointer, Class>::type;
-				object fn = make_function(L, construct<Class, pointer, Signature>(), Signature(), Policies());
+				object fn = make_function(L, construct_type(), Signature(), Policies());
 				add_overload(object(from_stack(L, -1)), "__init", fn);
 			}
 		};
@@ -324,12 +351,30 @@ namespace luabind {
 		struct inject_dependency_policy
 		{
 			using type = typename std::conditional <
-				is_primitive<T>::value || meta::contains<Policies, call_policy_injector< detail::no_dependency_policy > >::value,
+				is_primitive<T>::value || meta::contains<Policies, call_policy_injector< detail::no_dependency_policy > >::value
+					|| meta::contains<Policies, converter_policy_injector< 0, detail::cached_reference_policy > >::value,
 				Policies,
 				typename meta::push_back< Policies, call_policy_injector< dependency_policy<0, 1> > >::type
 			>::type;
 		};
 
+		template <class Get, class GetPolicies, class Set, class SetPolicies>
+		struct is_direct_property
+			: std::false_type
+		{};
+
+		// Only plain members, read-only or written through the same member
+		// pointer, are accessed in place. A setter function must be called.
+		template <class T, class D>
+		struct is_direct_property<D T::*, no_policies, null_type, no_policies>
+			: is_direct_member<typename std::remove_const<D>::type>
+		{};
+
+		template <class T, class D>
+		struct is_direct_property<D T::*, no_policies, D T::*, no_policies>
+			: is_direct_member<typename std::remove_const<D>::type>
+		{};
+
 		template <class Class, class Get, class GetPolicies, class Set = null_type, class SetPolicies = no_policies >
 		struct property_registration : registration
 		{
@@ -381,13 +426,63 @@ namespace luabind {
 				context[name] = property(get_);
 			}
 
-			// register entry
-			void register_(lua_State* L) const
+			// members that are read and written in place, see member_accessor
+			template <class SetterType>
+			void register_direct(lua_State* L, object const& context, object const& get_, SetterType const&) const
+			{
+				get_.push(L);
+				make_set(L, set, std::true_type()).push(L);
+				push_member_accessor<Class>(L, get, std::true_type());
+				lua_pushcclosure(L, &property_tag, 3);
+				context[name] = object(from_stack(L, -1));
+				lua_pop(L, 1);
+			}
+
+			void register_direct(lua_State* L, object const& context, object const& get_, null_type) const
+			{
+				get_.push(L);
+				lua_pushnil(L);
+				push_member_accessor<Class>(L, get, std::false_type());
+				lua_pushcclosure(L, &property_tag, 3);
+				context[name] = object(from_stack(L, -1));
+				lua_pop(L, 1);
+			}
+
+			void register_(lua_State* L, std::false_type /*direct*/) const
 			{
 				object context(from_stack(L, -1));
 				register_aux(L, context, make_get(L, get, std::is_member_object_pointer<Get>()), set);
 			}
 
+			static bool same_member(Get const&, null_type)
+			{
+				return true;
+			}
+
+			static bool same_member(Get const& get_, Get const& set_)
+			{
+				return get_ == set_;
+			}
+
+			void register_(lua_State* L, std::true_type /*direct*/) const
+			{
+				// The accessor writes the member read by get.
+				if(!same_member(get, set))
+				{
+					register_(L, std::false_type());
+					return;
+				}
+
+				object context(from_stack(L, -1));
+				register_direct(L, context, make_get(L, get, std::true_type()), set);
+			}
+
+			// register entry
+			void register_(lua_State* L) const
+			{
+				register_(L, is_direct_property<Get, GetPolicies, Set, SetPolicies>());
+			}
+
 
 			char const* name;
 			Get get;
@@ -481,6 +576,21 @@ namespace luabind {
 		// End of reworked property overloads
 		// =====================
 
+		// Reserves storage in every instance for a field assigned from Lua.
+		class_& def_slot(const char* name)
+		{
+			this->add_slot(name);
+			return *this;
+		}
+
+		// Pushes the same instance every time a pointer to an object of
+		// this class is passed to Lua, for as long as that instance lives.
+		class_& identity_map()
+		{
+			this->add_identity_map();
+			return *this;
+		}
+
 		template<class Derived, typename... Injectors>
 		class_& def(detail::operator_<Derived>, policy_list<Injectors...> policies = no_policies())
 		{
@@ -583,6 +693,7 @@ namespace luabind {
 			using registration_type = detail::constructor_registration<construct_type, HolderType, signature_type, policy_list_type>;
 			this->add_member(new registration_type());
 			this->add_default_member(new registration_type());
+			this->add_holder_size(detail::holder_storage_size<typename registration_type::construct_type::holder_type>());
 
 			return *this;
 		}
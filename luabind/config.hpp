@@ -69,6 +69,18 @@
 // by luabind throws an exception (throwing exceptions through
 // C code has undefined behavior, lua is written in C).
 
+// LUABIND_NO_VTABLE_CACHE
+// define this to always use typeid and dynamic_cast to find
+// the most derived class of polymorphic objects pushed to lua.
+// By default the result is remembered per vtable pointer, which
+// is only done on compilers using the Itanium C++ ABI, where
+// every polymorphic object starts with a pointer to a vtable
+// that belongs to exactly one most derived type.
+
+#if !defined(LUABIND_NO_VTABLE_CACHE) && defined(__GXX_ABI_VERSION)
+# define LUABIND_VTABLE_CACHE
+#endif
+
 #ifdef LUABIND_DYNAMIC_LINK
 # if defined (_WIN32)
 #  ifdef LUABIND_BUILDING
@@ -12,6 +12,7 @@
 #include <luabind/yield_policy.hpp>
 #include <luabind/detail/decorate_type.hpp>
 #include <luabind/detail/object.hpp>
+#include <vector>
 
 #ifdef LUABIND_NO_INTERNAL_TAG_ARGUMENTS
 #include <tuple>
@@ -21,28 +22,57 @@ namespace luabind {
 	namespace detail {
 
 		struct invoke_context;
+		struct overload_cache;
+		struct overload_tree;
 
 		struct LUABIND_API function_object
 		{
-			function_object(lua_CFunction entry)
+			function_object(lua_CFunction entry, lua_CFunction single_entry = 0, bool shape_matched = false)
 				: entry(entry)
+				, single_entry(single_entry)
 				, next(0)
+				, shape_matched(shape_matched)
+				, cache(0)
+				, tree(0)
 			{}
 
-			virtual ~function_object()
-			{}
+			virtual ~function_object();
 
+			// Matches and calls this overload alone, ignoring the rest of the chain.
 			virtual int call(lua_State* L, invoke_context& ctx) /* const */ = 0;
+			// Scores the arguments on the stack against this overload alone.
+			virtual int score(lua_State* L) const = 0;
+			virtual int arity() const = 0;
+			// The Lua types the argument at the given stack index can have.
+			virtual unsigned int argument_types(int index) const = 0;
 			virtual void format_signature(lua_State* L, char const* function) const = 0;
 
+			// Resolves the overload chain starting here and calls the best match.
+			// Chains made only of shape matched overloads remember the winner for
+			// each argument shape they have seen.
+			int dispatch(lua_State* L, invoke_context& ctx);
+			void invalidate_cache();
+			// Builds the decision tree that narrows the chain down by arity and
+			// Lua argument types.
+			void build_tree();
+
 			lua_CFunction entry;
+			// Entry point used while the function has no other overloads.
+			lua_CFunction single_entry;
 			std::string name;
 			function_object* next;
 			object keepalive;
+			// True if this overload and every one after it score arguments by
+			// shape alone.
+			bool shape_matched;
+			overload_cache* cache;
+			overload_tree* tree;
 		};
 
 		struct LUABIND_API invoke_context
 		{
+			enum { inline_candidates = 10 };
+
 			invoke_context()
 				: best_score((std::numeric_limits<int>::max)())
 				//This need to avoid static analyzer's treats
@@ -56,10 +86,35 @@ namespace luabind {
 				return candidate_index == 1;
 			}
 
+			// Keeps track of the overloads tied for the best score so far.
+			void record(function_object const* f, int score)
+			{
+				if(score >= 0 && score < best_score) {
+					best_score = score;
+					candidate_index = 0;
+					extra_candidates.clear();
+				} else if(score != best_score) {
+					return;
+				}
+
+				if(candidate_index < inline_candidates)
+					candidates[candidate_index] = f;
+				else
+					extra_candidates.push_back(f);
+				++candidate_index;
+			}
+
+			function_object const* candidate(int index) const
+			{
+				return index < inline_candidates ? candidates[index] : extra_candidates[index - inline_candidates];
+			}
+
 			void format_error(lua_State* L, function_object const* overloads) const;
 
 			int best_score;
-			function_object const* candidates[10];	// This looks like it could crash if you provide too many overloads?
+			function_object const* candidates[inline_candidates];
+			// Ties beyond the inline buffer, only large ambiguous sets get here.
+			std::vector<function_object const*> extra_candidates;
 			int candidate_index;
 		};
 
@@ -324,6 +379,14 @@ namespace luabind {
 		template< typename ConverterList >
 		struct build_consumed_list;
 
+		template< typename ConverterList >
+		struct all_shape_matched;
+
+		template< typename... Converters >
+		struct all_shape_matched< meta::type_list< Converters... > >
+			: meta::and_< std::is_base_of< shape_matched_converter_tag, Converters >... >
+		{};
+
 		template< typename... Converters >
 		struct build_consumed_list< meta::type_list< Converters... > > {
 			using consumed_list = meta::index_list< call_detail_new::FooFoo<Converters>::consumed_args... >;
@@ -350,6 +413,7 @@ namespace luabind {
 			using consumed_list = typename build_consumed_list<argument_converter_list>::consumed_list;
 			using stack_index_list = typename call_detail_new::compute_stack_indices< consumed_list, 1 >::type;
 			enum { arity = meta::sum<consumed_list>::value };
+			enum { shape_matched = all_shape_matched<argument_converter_list>::value };
 		};
 
 		template< typename StackIndexList, typename SignatureList, unsigned int End = meta::size<SignatureList>::value, unsigned int Index = 1 >
@@ -480,55 +544,84 @@ namespace luabind {
 				}
 			};
 
-			static int invoke(lua_State* L, function_object const& self, invoke_context& ctx, F& f) {
-				int const arguments = lua_gettop(L);
-				int score = no_match;
+			static int match(lua_State* L, typename traits::argument_converter_tuple_type& converter_tuple)
+			{
+				if(traits::arity != lua_gettop(L))
+					return no_match;
+
+				// Things to remember:
+				// 0 is the perfect match. match > 0 means that objects had to be casted, where the value
+				// is the total distance of all arguments to their given types (graph distance).
+				// This is why we can say MaxArguments = 100, MaxDerivationDepth = 100, so no match will be > 100*100=10k and -10k1 absorbs every match.
+				// This gets rid of the awkward checks during converter match traversal.
+				using struct_type = match_struct< typename traits::stack_index_list, typename traits::signature_list >;
+				return struct_type::match(L, converter_tuple);
+			}
 
-				// Even match needs the tuple, since pointer_converters buffer the cast result
-				typename traits::argument_converter_tuple_type converter_tuple;
+			static int call_matched(lua_State* L, F& f, typename traits::argument_converter_tuple_type& converter_tuple)
+			{
+				call_struct<
+					std::is_member_function_pointer<F>::value,
+					std::is_void<typename traits::result_type>::value,
+					typename traits::argument_index_list
+				>::call(L, f, converter_tuple);
 
-				if(traits::arity == arguments) {
-					// Things to remember:
-					// 0 is the perfect match. match > 0 means that objects had to be casted, where the value
-					// is the total distance of all arguments to their given types (graph distance).
-					// This is why we can say MaxArguments = 100, MaxDerivationDepth = 100, so no match will be > 100*100=10k and -10k1 absorbs every match.
-					// This gets rid of the awkward checks during converter match traversal.
-					using struct_type = match_struct< typename traits::stack_index_list, typename traits::signature_list >;
-					score = struct_type::match(L, converter_tuple);
+				int results = lua_gettop(L) - traits::arity;
+				if(has_call_policy<PolicyList, yield_policy>::value) {
+					results = lua_yield(L, results);
 				}
 
-				if(score >= 0 && score < ctx.best_score) {
-					ctx.best_score = score;
-					ctx.candidates[0] = &self;
-					ctx.candidate_index = 1;
-				} else if(score == ctx.best_score) {
-					ctx.candidates[ctx.candidate_index++] = &self;
-				}
+				call_detail_new::policy_list_postcall < PolicyList, typename meta::push_front< typename traits::stack_index_list, meta::index<traits::arity> >::type >::postcall(L, results);
+				return results;
+			}
 
-				int results = 0;
+			static int score(lua_State* L)
+			{
+				typename traits::argument_converter_tuple_type converter_tuple;
+				return match(L, converter_tuple);
+			}
 
-				if(self.next)
-				{
-					results = self.next->call(L, ctx);
-				}
+			template< unsigned int... ArgumentIndices >
+			static unsigned int argument_types(int index, meta::index_list<ArgumentIndices...>)
+			{
+				using converters = typename traits::argument_converter_list;
+				using consumed = typename traits::consumed_list;
+				using stack_indices = typename traits::stack_index_list;
+
+				// Converters consuming several arguments may accept anything at each of them.
+				unsigned int types = ~0u;
+				meta::init_order{
+					(index == int(meta::get<stack_indices, ArgumentIndices>::value) && meta::get<consumed, ArgumentIndices>::value == 1
+					 ? (types = converter_lua_types< typename meta::get<converters, ArgumentIndices>::type >::value, 0) : 0)...
+				};
+				return types;
+			}
 
-				if(score == ctx.best_score && ctx.candidate_index == 1)
-				{
-					call_struct<
-						std::is_member_function_pointer<F>::value,
-						std::is_void<typename traits::result_type>::value,
-						typename traits::argument_index_list
-					>::call(L, f, converter_tuple);
-
-					results = lua_gettop(L) - traits::arity;
-					if(has_call_policy<PolicyList, yield_policy>::value) {
-						results = lua_yield(L, results);
-					}
-
-					call_detail_new::policy_list_postcall < PolicyList, typename meta::push_front< typename traits::stack_index_list, meta::index<traits::arity> >::type >::postcall(L, results);
-				}
+			static unsigned int argument_types(int index)
+			{
+				return argument_types(index, typename traits::argument_index_list());
+			}
 
-				return results;
+			static bool try_invoke(lua_State* L, F& f, int& results) {
+				typename traits::argument_converter_tuple_type converter_tuple;
+				if(match(L, converter_tuple) < 0)
+					return false;
+
+				results = call_matched(L, f, converter_tuple);
+				return true;
+			}
+
+			static int invoke(lua_State* L, function_object const& self, invoke_context& ctx, F& f) {
+				typename traits::argument_converter_tuple_type converter_tuple;
+				int const score = match(L, converter_tuple);
+
+				if(score < 0)
+					return 0;
+
+				ctx.best_score = score;
+				ctx.candidates[0] = &self;
+				ctx.candidate_index = 1;
+				return call_matched(L, f, converter_tuple);
 			}
 
 		};
@@ -538,6 +631,14 @@ namespace luabind {
 		{
 			return invoke_struct<PolicyList, Signature, F>::invoke(L, self, ctx, f);
 		}
+
+		// Calls f if the arguments on the stack match it, without setting up an
+		// invoke_context. Returns false if they do not match.
+		template< typename PolicyList, typename Signature, typename F>
+		inline bool try_invoke(lua_State* L, function_object const& /*self*/, F& f, int& results)
+		{
+			return invoke_struct<PolicyList, Signature, F>::try_invoke(L, f, results);
+		}
 #endif
 
 	}
@@ -24,7 +24,7 @@
 #ifndef LUABIND_CLASS_REGISTRY_HPP_INCLUDED
 #define LUABIND_CLASS_REGISTRY_HPP_INCLUDED
 
-#include <map>
+#include <unordered_map>
 
 #include <luabind/config.hpp>
 #include <luabind/open.hpp>
@@ -52,14 +52,16 @@ namespace luabind {
 
 			class_rep* find_class(type_id const& info) const;
 
-			std::map<type_id, class_rep*> const& get_classes() const
+			using class_map_type = std::unordered_map<type_id, class_rep*>;
+
+			class_map_type const& get_classes() const
 			{
 				return m_classes;
 			}
 
 		private:
 
-			std::map<type_id, class_rep*> m_classes;
+			class_map_type m_classes;
 
 			// this is a lua reference that points to the lua table
 			// that is to be used as meta table for all C++ class 
@@ -33,6 +33,7 @@
 #include <luabind/detail/garbage_collector.hpp>
 #include <luabind/detail/operator_id.hpp>
 #include <luabind/detail/class_registry.hpp>
+#include <luabind/detail/inheritance.hpp>
 #include <luabind/error.hpp>
 #include <luabind/handle.hpp>
 #include <luabind/detail/primitives.hpp>
@@ -62,6 +63,12 @@ namespace luabind {
 
 		class cast_graph;
 		class class_id_map;
+		class instance_holder;
+		struct function_object;
+
+		// Holder storage of instances created before the holder type is known,
+		// for classes that do not say how much their constructors need.
+		std::size_t const default_holder_storage_size = 32;
 
 		class LUABIND_API class_rep
 		{
@@ -106,7 +113,29 @@ namespace luabind {
 				class_rep* base;
 			};
 
-			void add_base_class(const base_info& binfo);
+			void add_base_class(lua_State* L, const base_info& binfo);
+
+			// The holder storage that instances constructed from Lua get.
+			std::size_t holder_size() const { return m_holder_size; }
+			void set_holder_size(std::size_t size) { m_holder_size = size; }
+
+			// Lua fields that instances store in numbered slots rather than
+			// in a table of their own. Base class slots are inherited.
+			int slot_count() const { return m_slot_count; }
+			void add_slot(lua_State* L, char const* name);
+			// pushes the table mapping slot names to their 1-based index
+			void get_slot_table(lua_State* L) const { m_slots.push(L); }
+
+			// Instances made for pointers to objects of this class, by the
+			// address of the most derived object, see class_::identity_map().
+			// Inherited from base classes.
+			bool has_identity_map() const { return m_identity_map; }
+			void enable_identity_map(lua_State* L);
+			// Pushes the instance for p and returns true, if it is still alive.
+			bool get_identity(lua_State* L, void const* p) const;
+			void set_identity(lua_State* L, void const* p, int index);
+			// Forgets the instance at the absolute index, if it is the one for p.
+			void remove_identity(lua_State* L, void const* p, int index);
 
 			const std::vector<base_info>& bases() const throw() { return m_bases; }
 
@@ -115,15 +144,19 @@ namespace luabind {
 
 			const char* name() const throw() { return m_name; }
 
-			// the lua reference to the metatable for this class' instances
-			int metatable_ref() const throw() { return m_instance_metatable; }
+			// pushes the metatable for this class' instances
+			void get_instance_metatable(lua_State* L);
 
 			void get_table(lua_State* L) const { m_table.push(L); }
 			void get_default_table(lua_State* L) const { m_default_table.push(L); }
 
 			class_type get_class_type() const { return m_class_type; }
 
-			void add_static_constant(const char* name, int val);
+			// False as long as nothing named __finalize has been put in the
+			// class table, so instances can be collected without looking it up.
+			bool may_have_finalizer() const { return m_may_have_finalizer; }
+			// Sets the flag if the class table has a __finalize.
+			void check_finalizer(lua_State* L);
 
 			static int super_callback(lua_State* L);
 
@@ -135,6 +168,23 @@ namespace luabind {
 
 			bool has_operator_in_lua(lua_State*, int id);
 
+			// The luabind function bound to operator id, or null if the class
+			// table has something else there.
+			function_object* operator_function(lua_State* L, int id);
+
+			// What a virtual function wrapper calling name dispatches to: a
+			// function defined in Lua, or the default implementation bound
+			// from C++. Kept until the class table is written.
+			struct member_override
+			{
+				std::string name;
+				bool overridden;
+				handle function;
+			};
+
+			// Null if name is a property of the class.
+			member_override const* find_member_override(lua_State* L, char const* name);
+
 			cast_graph const& casts() const
 			{
 				return *m_casts;
@@ -145,6 +195,10 @@ namespace luabind {
 				return *m_classes;
 			}
 
+			// Casts the object held by an instance of this class to target, like
+			// instance_holder::get() but remembering the offsets found.
+			std::pair<void*, int> cast_instance(instance_holder const& holder, class_id target) const;
+
 		private:
 
 			// Code common to both constructors
@@ -152,6 +206,14 @@ namespace luabind {
 
 			void cache_operators(lua_State*);
 
+			// Makes instances look up members with get_instance_value again,
+			// needed as soon as the class has a property.
+			void use_instance_index_function(lua_State* L);
+
+			// The luabind function in __init, or null if it is something else.
+			// Looked up again after members are assigned from Lua.
+			function_object* init_function(lua_State* L);
+
 			// this is a pointer to the type_info structure for
 			// this type
 			// warning: this may be a problem when using dll:s, since
@@ -187,20 +249,50 @@ namespace luabind {
 			// the type of this class.. determines if it's written in c++ or lua
 			class_type m_class_type;
 
-			// this is a lua reference that points to the lua table
-			// that is to be used as meta table for all instances
-			// of this class.
-			int m_instance_metatable;
+			// the metatable for all instances of this class. A copy of the
+			// registry's instance metatable, except that __index is the class
+			// table itself while the class has no properties.
+			handle m_instance_metatable;
+			// true once __index of m_instance_metatable has been chosen
+			bool m_instance_index_resolved;
 
-			std::map<const char*, int, ltstr> m_static_constants;
+			bool m_may_have_finalizer;
 
 			// the first time an operator is invoked
 			// we check the associated lua table
 			// and cache the result
 			int m_operator_cache;
+			function_object* m_operators[number_of_operators];
+
+			std::vector<member_override> m_overrides;
+
+			std::size_t m_holder_size;
+
+			handle m_slots;
+			int m_slot_count;
+
+			handle m_identities;
+			bool m_identity_map;
+
+			function_object* m_init;
+			bool m_init_cached;
 
 			cast_graph* m_casts;
 			class_id_map* m_classes;
+
+			struct cast_offset
+			{
+				std::ptrdiff_t offset;
+				// -1 if there is no cast, -2 if it has not been looked up yet
+				int distance;
+			};
+
+			// Cast offsets from objects whose static and dynamic class are both
+			// m_cast_source, indexed by target class id. Cleared when the cast
+			// graph changes.
+			mutable std::vector<cast_offset> m_cast_offsets;
+			mutable class_id m_cast_source;
+			mutable std::size_t m_cast_generation;
 		};
 
 		LUABIND_API bool is_class_rep(lua_State* L, int index);
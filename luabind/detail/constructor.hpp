@@ -9,6 +9,8 @@
 #include <luabind/lua_argument_proxy.hpp>
 #include <luabind/wrapper_base.hpp>
 #include <luabind/detail/inheritance.hpp>
+#include <luabind/detail/instance_holder.hpp>
+#include <luabind/detail/object_rep.hpp>
 
 namespace luabind {
 	namespace detail {
@@ -40,13 +42,49 @@ namespace luabind {
 				void* naked_ptr = instance.get();
 				Pointer ptr(instance.release());
 
-				void* storage = self->allocate(sizeof(holder_type));
+				void* storage = self->allocate(sizeof(holder_type), alignof(holder_type));
 
 				self->set_instance(new (storage) holder_type(std::move(ptr), registered_class<T>::id, naked_ptr));
 			}
 		};
 
 
+		template< class T, class Signature, class Arguments, class ArgumentIndices >
+		struct construct_in_place_aux_helper;
+
+		// Constructs the object inside the instance userdata, held by value.
+		template< class T, class Signature, typename... Arguments, unsigned int... ArgumentIndices >
+		struct construct_in_place_aux_helper< T, Signature, meta::type_list< Arguments... >, meta::index_list< ArgumentIndices... > >
+		{
+			using holder_type = value_holder<T>;
+
+			void operator()(argument const& self_, Arguments... args) const
+			{
+				object_rep* self = touserdata<object_rep>(self_);
+
+				void* storage = self->allocate(sizeof(holder_type), alignof(holder_type));
+
+				try
+				{
+					self->set_instance(new (storage) holder_type(self_.interpreter(), in_place_t(), args...));
+				}
+				catch(...)
+				{
+					self->deallocate(storage);
+					throw;
+				}
+			}
+		};
+
+		template< class T, class Signature >
+		struct construct_in_place :
+			public construct_in_place_aux_helper <
+			T,
+			Signature, typename meta::sub_range< Signature, 2, meta::size<Signature>::value >::type,
+			typename meta::make_index_range<0, meta::size<Signature>::value - 2>::type >
+		{
+		};
+
 		template< class T, class Pointer, class Signature >
 		struct construct :
 			public construct_aux_helper <
@@ -40,6 +40,7 @@ namespace luabind {
 
 	template <>
 	struct default_converter<lua_State*>
+		: detail::shape_matched_converter_tag
 	{
 		enum { consumed_args = 0 };
 
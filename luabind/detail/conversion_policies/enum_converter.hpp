@@ -42,13 +42,13 @@ namespace luabind {
 			template<class T>
 			void to_lua(lua_State* L, T val)
 			{
-				lua_pushnumber(L, detail::unchecked_enum_helper<T, lua_Number>::CastToLuaNumber(val));
+				push(L, detail::unchecked_enum_helper<T, enum_number_type>::CastToLuaNumber(val));
 			}
 
 			template<class T>
 			T to_cpp(lua_State* L, by_value<T>, int index)
 			{
-				return detail::unchecked_enum_helper<T, lua_Number>::CastFromLuaNumber(lua_tonumber(L, index));
+				return detail::unchecked_enum_helper<T, enum_number_type>::CastFromLuaNumber(to_number(L, index));
 			}
 
 			template<class T>
@@ -64,7 +64,7 @@ namespace luabind {
 			template<class T>
 			T to_cpp(lua_State* L, by_const_reference<T>, int index)
 			{
-				return detail::unchecked_enum_helper<T, lua_Number>::CastFromLuaNumber(lua_tonumber(L, index));
+				return detail::unchecked_enum_helper<T, enum_number_type>::CastFromLuaNumber(to_number(L, index));
 			}
 
 			template<class T>
@@ -75,6 +75,19 @@ namespace luabind {
 
 			template<class T>
 			void converter_postcall(lua_State*, T, int) {}
+
+		private:
+			static void push(lua_State* L, lua_Number v) { lua_pushnumber(L, v); }
+			static void push(lua_State* L, lua_Integer v) { lua_pushinteger(L, v); }
+
+			static enum_number_type to_number(lua_State* L, int index)
+			{
+#if LUA_VERSION_NUM >= 503
+				return lua_tointeger(L, index);
+#else
+				return lua_tonumber(L, index);
+#endif
+			}
 		};
 
 	}
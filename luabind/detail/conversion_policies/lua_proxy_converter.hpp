@@ -18,6 +18,7 @@
 #define LUABIND_VALUE_WRAPPER_CONVERTER_HPP_INCLUDED
 
 #include <luabind/lua_proxy.hpp>
+#include <luabind/detail/policy.hpp>
 #include <type_traits>
 
 namespace luabind {
@@ -25,6 +26,7 @@ namespace luabind {
 
 		template <class U>
 		struct lua_proxy_converter
+			: shape_matched_converter_tag
 		{
 			using type      = lua_proxy_converter<U>;
 			using is_native = std::true_type;
@@ -89,12 +89,14 @@ namespace luabind {
 
 	template <typename QualifiedT>
 	struct integer_converter
-		: native_converter_base<remove_const_reference_t<QualifiedT>>
+		: native_converter_base<remove_const_reference_t<QualifiedT>>, detail::shape_matched_converter_tag
 	{
 		using T = remove_const_reference_t<QualifiedT>;
 		using value_type = typename native_converter_base<T>::value_type;
 		using param_type = typename native_converter_base<T>::param_type;
 
+		enum { lua_types = 1 << LUA_TNUMBER };
+
 		static int compute_score(lua_State* L, int index)
 		{
 			return lua_type(L, index) == LUA_TNUMBER ? 0 : no_match;
@@ -122,12 +124,14 @@ namespace luabind {
 
 	template <typename QualifiedT>
 	struct number_converter
-		: native_converter_base<remove_const_reference_t<QualifiedT>>
+		: native_converter_base<remove_const_reference_t<QualifiedT>>, detail::shape_matched_converter_tag
 	{
 		using T = remove_const_reference_t<QualifiedT>;
 		using value_type = typename native_converter_base<T>::value_type;
 		using param_type = typename native_converter_base<T>::param_type;
 
+		enum { lua_types = 1 << LUA_TNUMBER };
+
 		static int compute_score(lua_State* L, int index)
 		{
 			return lua_type(L, index) == LUA_TNUMBER ? 0 : no_match;
@@ -146,8 +150,10 @@ namespace luabind {
 
 	template <>
 	struct default_converter<bool>
-		: native_converter_base<bool>
+		: native_converter_base<bool>, detail::shape_matched_converter_tag
 	{
+		enum { lua_types = 1 << LUA_TBOOLEAN };
+
 		static int compute_score(lua_State* L, int index)
 		{
 			return lua_type(L, index) == LUA_TBOOLEAN ? 0 : no_match;
@@ -177,8 +183,10 @@ namespace luabind {
 
 	template <>
 	struct default_converter<std::string>
-		: native_converter_base<std::string>
+		: native_converter_base<std::string>, detail::shape_matched_converter_tag
 	{
+		enum { lua_types = 1 << LUA_TSTRING };
+
 		static int compute_score(lua_State* L, int index)
 		{
 			return lua_type(L, index) == LUA_TSTRING ? 0 : no_match;
@@ -212,10 +220,12 @@ namespace luabind {
 
 	template <>
 	struct default_converter<char const*>
+		: detail::shape_matched_converter_tag
 	{
 		using is_native = std::true_type;
 
 		enum { consumed_args = 1 };
+		enum { lua_types = (1 << LUA_TSTRING) | (1 << LUA_TNIL) };
 
 		template <class U>
 		static int match(lua_State* L, U, int index)
@@ -19,6 +19,7 @@
 
 #include <type_traits>
 #include <luabind/lua_include.hpp>
+#include <luabind/detail/policy.hpp>
 #include <luabind/detail/make_instance.hpp>
 #include <luabind/back_reference.hpp>
 
@@ -31,6 +32,7 @@ namespace luabind {
 	namespace detail {
 
 		struct pointer_converter
+			: shape_matched_converter_tag
 		{
 			using type      = pointer_converter;
 			using is_native = std::false_type;
@@ -42,6 +44,7 @@ namespace luabind {
 			void* result;
 
 			enum { consumed_args = 1 };
+			enum { lua_types = (1 << LUA_TUSERDATA) | (1 << LUA_TNIL) };
 
 			template<class T>
 			static void to_lua(lua_State* L, T* ptr)
@@ -85,11 +88,13 @@ namespace luabind {
 		};
 
 		struct const_pointer_converter
+			: shape_matched_converter_tag
 		{
 			using type      = const_pointer_converter;
 			using is_native = std::false_type;
 
 			enum { consumed_args = 1 };
+			enum { lua_types = (1 << LUA_TUSERDATA) | (1 << LUA_TNIL) };
 
 			const_pointer_converter()
 				: result(0)
@@ -35,6 +35,7 @@ namespace luabind {
 			using is_native = std::false_type;
 
 			enum { consumed_args = 1 };
+			enum { lua_types = 1 << LUA_TUSERDATA };
 
 			template<class T>
 			void to_lua(lua_State* L, T& ref)
@@ -71,11 +72,13 @@ namespace luabind {
 		};
 
 		struct const_ref_converter
+			: shape_matched_converter_tag
 		{
 			using type      = const_ref_converter;
 			using is_native = std::false_type;
 
 			enum { consumed_args = 1 };
+			enum { lua_types = 1 << LUA_TUSERDATA };
 
 			const_ref_converter()
 				: result(0)
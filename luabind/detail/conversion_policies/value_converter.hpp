@@ -19,6 +19,7 @@
 
 #include <type_traits>
 #include <luabind/lua_include.hpp>
+#include <luabind/detail/policy.hpp>
 #include <luabind/back_reference.hpp>
 #include <luabind/detail/object_rep.hpp>
 
@@ -26,11 +27,13 @@ namespace luabind {
 	namespace detail {
 
 		struct value_converter
+			: shape_matched_converter_tag
 		{
 			using type      = value_converter;
 			using is_native = std::false_type;
 
 			enum { consumed_args = 1 };
+			enum { lua_types = 1 << LUA_TUSERDATA };
 
 			value_converter()
 				: result(0)
@@ -65,7 +65,7 @@ namespace luabind {
 		{}
 
 		const char* name_;
-		int val_;
+		detail::enum_value_type val_;
 
 		value_vector operator,(const value& rhs) const
 		{
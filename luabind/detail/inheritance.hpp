@@ -5,10 +5,12 @@
 # define LUABIND_INHERITANCE_090217_HPP
 
 # include <luabind/config.hpp>
+# include <array>
 # include <cassert>
+# include <cstddef>
 # include <limits>
-# include <map>
 # include <memory>
+# include <unordered_map>
 # include <vector>
 # include <luabind/typeid.hpp>
 
@@ -36,6 +38,10 @@ namespace luabind {
 			std::pair<void*, int> cast(void* p, class_id src, class_id target, class_id dynamic_id, void const* dynamic_ptr) const;
 			void insert(class_id src, class_id target, cast_function cast);
 
+			// Changes whenever a cast is inserted, so that results derived from
+			// earlier casts can be told apart.
+			std::size_t generation() const;
+
 		private:
 			class impl;
 			std::unique_ptr<impl> m_impl;
@@ -54,17 +60,39 @@ namespace luabind {
 			class_id get_local(type_id const& type);
 			void put(class_id id, type_id const& type);
 
+			// The class id and offset to the most derived object remembered
+			// for objects with the vtable pointer `vtable`.
+			struct vtable_entry
+			{
+				void const* vtable;
+				class_id id;
+				std::ptrdiff_t offset;
+			};
+
+			vtable_entry const* find_vtable(void const* vtable) const;
+			void put_vtable(void const* vtable, class_id id, std::ptrdiff_t offset);
+
 		private:
-			using map_type = std::map<type_id, class_id>;
+			using map_type = std::unordered_map<type_id, class_id>;
 			map_type m_classes;
 			class_id m_local_id;
 
+			static std::size_t vtable_slot(void const* vtable)
+			{
+				return (reinterpret_cast<std::size_t>(vtable) >> 3) % vtable_cache_size;
+			}
+
+			static std::size_t const vtable_cache_size = 64;
+			std::array<vtable_entry, vtable_cache_size> m_vtables;
+
 			static class_id const local_id_base;
 		};
 
 		inline class_id_map::class_id_map()
 			: m_local_id(local_id_base)
-		{}
+		{
+			m_vtables.fill(vtable_entry{ nullptr, unknown_class, 0 });
+		}
 
 		inline class_id class_id_map::get(type_id const& type) const
 		{
@@ -100,6 +128,20 @@ namespace luabind {
 			);
 
 			result.first->second = id;
+
+			// The type may have been given a local id that is remembered.
+			m_vtables.fill(vtable_entry{ nullptr, unknown_class, 0 });
+		}
+
+		inline class_id_map::vtable_entry const* class_id_map::find_vtable(void const* vtable) const
+		{
+			vtable_entry const& e = m_vtables[vtable_slot(vtable)];
+			return e.vtable == vtable ? &e : nullptr;
+		}
+
+		inline void class_id_map::put_vtable(void const* vtable, class_id id, std::ptrdiff_t offset)
+		{
+			m_vtables[vtable_slot(vtable)] = vtable_entry{ vtable, id, offset };
 		}
 
 		class class_map
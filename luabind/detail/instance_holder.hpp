@@ -16,8 +16,9 @@ namespace luabind {
 		class instance_holder
 		{
 		public:
-			instance_holder(bool pointee_const)
-				: m_pointee_const(pointee_const)
+			instance_holder(bool pointee_const, class_id dynamic_id, class_id pointee_id, class_id holder_id)
+				: m_pointee_const(pointee_const), m_dynamic_id(dynamic_id)
+				, m_pointee_id(pointee_id), m_holder_id(holder_id)
 			{}
 
 			virtual ~instance_holder()
@@ -31,17 +32,52 @@ namespace luabind {
 				return m_pointee_const;
 			}
 
+			// The class id of the most derived type of the held object.
+			class_id dynamic_id() const
+			{
+				return m_dynamic_id;
+			}
+
+			// The class id of the static type of the held object, and the object.
+			// get() returns exactly this pointer, with a score of 0, for that id.
+			class_id pointee_id() const
+			{
+				return m_pointee_id;
+			}
+
+			// Read from the holder on every call, C++ may reassign a smart
+			// pointer it got a reference to.
+			virtual void* pointee() const = 0;
+
+			// The most derived object, which pointee() is a base of.
+			virtual void* dynamic_pointer() const
+			{
+				return pointee();
+			}
+
+			// The class id of the holder type itself, get() special cases it.
+			class_id holder_id() const
+			{
+				return m_holder_id;
+			}
+
 		private:
 			bool m_pointee_const;
+			class_id m_dynamic_id;
+			class_id m_pointee_id;
+			class_id m_holder_id;
 		};
 
 		template <class P, class Pointee = void const>
 		class pointer_holder : public instance_holder
 		{
 		public:
+			using pointee_type = typename std::remove_cv<typename std::remove_reference<decltype(*get_pointer(std::declval<P>()))>::type>::type;
+
 			pointer_holder(P p, class_id dynamic_id, void* dynamic_ptr) :
-				instance_holder(detail::is_pointer_to_const<P>()),
-				p(std::move(p)), weak(0), dynamic_id(dynamic_id), dynamic_ptr(dynamic_ptr)
+				instance_holder(detail::is_pointer_to_const<P>(), dynamic_id,
+					registered_class<pointee_type>::id, registered_class<P>::id),
+				p(std::move(p)), weak(0), dynamic_ptr(dynamic_ptr)
 			{
 			}
 
@@ -50,14 +86,12 @@ namespace luabind {
 				// if somebody wants the smart-ptr, he can get a reference to it
 				if(target == registered_class<P>::id) return std::pair<void*, int>(&this->p, 0);
 
-				void* naked_ptr = const_cast<void*>(static_cast<void const*>(weak ? weak : get_pointer(p)));
+				void* naked_ptr = pointee();
 				if(!naked_ptr) return std::pair<void*, int>(nullptr, 0);
 
-				using pointee_type = typename std::remove_cv<typename std::remove_reference<decltype(*get_pointer(p))>::type>::type;
-
 				return casts.cast(naked_ptr,
 					registered_class< pointee_type >::id,
-					target, dynamic_id, dynamic_ptr);
+					target, dynamic_id(), dynamic_ptr);
 			}
 
 			explicit operator bool() const
@@ -65,6 +99,16 @@ namespace luabind {
 				return p ? true : false;
 			}
 
+			void* pointee() const override
+			{
+				return const_cast<void*>(static_cast<void const*>(weak ? weak : get_pointer(p)));
+			}
+
+			void* dynamic_pointer() const override
+			{
+				return dynamic_ptr;
+			}
+
 			void release() override
 			{
 				weak = const_cast<void*>(static_cast<void const*>(get_pointer(p)));
@@ -77,10 +121,13 @@ namespace luabind {
 			// by p once p has released it's owership. This is a workaround
 			// to make adopt() work with virtual function wrapper classes.
 			void* weak;
-			class_id dynamic_id;
 			void* dynamic_ptr;
 		};
 
+		// Selects the value_holder constructor that constructs the value from
+		// the arguments.
+		struct in_place_t {};
+
 		template <class ValueType>
 		class value_holder :
 			public instance_holder
@@ -88,7 +135,16 @@ namespace luabind {
 		public:
 			// No need for dynamic_id / dynamic_ptr, since we always get the most derived type
 			value_holder(lua_State* /*L*/, ValueType val)
-				: instance_holder(false), val_(std::move(val))
+				: instance_holder(false, registered_class<ValueType>::id,
+					registered_class<ValueType>::id, registered_class<ValueType>::id),
+				val_(std::move(val))
+			{}
+
+			template <class... Args>
+			value_holder(lua_State* /*L*/, in_place_t, Args&&... args)
+				: instance_holder(false, registered_class<ValueType>::id,
+					registered_class<ValueType>::id, registered_class<ValueType>::id),
+				val_(std::forward<Args>(args)...)
 			{}
 
 			explicit operator bool() const
@@ -104,6 +160,11 @@ namespace luabind {
 				return casts.cast(naked_ptr, this_id, target, this_id, naked_ptr);
 			}
 
+			void* pointee() const override
+			{
+				return const_cast<void*>((const void*)&val_);
+			}
+
 			void release() override
 			{}
 
@@ -122,9 +183,10 @@ namespace luabind {
 			// No need for dynamic_id / dynamic_ptr, since we always get the most derived type
 			pointer_like_holder(lua_State* /*L*/, ValueType val, class_id dynamic_id, void* dynamic_ptr)
 				:
-				instance_holder(std::is_const< decltype(*get_pointer(val)) >::value),
+				instance_holder(std::is_const< decltype(*get_pointer(val)) >::value, dynamic_id,
+					registered_class< typename std::remove_cv<typename std::remove_reference<decltype(*get_pointer(val))>::type >::type >::id,
+					registered_class<ValueType>::id),
 				val_(std::move(val)),
-				dynamic_id_(dynamic_id),
 				dynamic_ptr_(dynamic_ptr)
 			{
 			}
@@ -143,8 +205,17 @@ namespace luabind {
 
 				using pointee_type = typename std::remove_cv<typename std::remove_reference<decltype(*get_pointer(val_))>::type >::type;
 				const auto pointee_id = registered_class< pointee_type >::id;
-				void* const naked_pointee_ptr = const_cast<void*>((const void*)get_pointer(val_));
-				return casts.cast(naked_pointee_ptr, pointee_id, target, dynamic_id_, dynamic_ptr_);
+				return casts.cast(pointee(), pointee_id, target, dynamic_id(), dynamic_ptr_);
+			}
+
+			void* pointee() const override
+			{
+				return const_cast<void*>((const void*)get_pointer(val_));
+			}
+
+			void* dynamic_pointer() const override
+			{
+				return dynamic_ptr_;
 			}
 
 			void release() override
@@ -152,7 +223,6 @@ namespace luabind {
 
 		private:
 			ValueType val_;
-			class_id dynamic_id_;
 			void* dynamic_ptr_;
 			// weak? must understand what the comment up there really means
 		};
@@ -7,33 +7,11 @@
 
 # include <luabind/detail/inheritance.hpp>
 # include <luabind/detail/object_rep.hpp>
+# include <luabind/detail/state_context.hpp>
 
 namespace luabind {
 	namespace detail {
 
-		template <class T>
-		std::pair<class_id, void*> get_dynamic_class_aux(lua_State* L, T const* p, std::true_type)
-		{
-			lua_pushliteral(L, "__luabind_class_id_map");
-			lua_rawget(L, LUA_REGISTRYINDEX);
-			class_id_map& class_ids = *static_cast<class_id_map*>(lua_touserdata(L, -1));
-			lua_pop(L, 1);
-
-			return std::make_pair(class_ids.get_local(typeid(*p)), dynamic_cast<void*>(const_cast<T*>(p)));
-		}
-
-		template <class T>
-		std::pair<class_id, void*> get_dynamic_class_aux(lua_State*, T const* p, std::false_type)
-		{
-			return std::make_pair(registered_class<T>::id, (void*)p);
-		}
-
-		template <class T>
-		std::pair<class_id, void*> get_dynamic_class(lua_State* L, T* p)
-		{
-			return get_dynamic_class_aux(L, p, std::is_polymorphic<T>());
-		}
-
 		template <class T>
 		class_rep* get_pointee_class(class_map const& classes, T*)
 		{
@@ -43,12 +21,7 @@ namespace luabind {
 		template <class P>
 		class_rep* get_pointee_class(lua_State* L, P const& p, class_id dynamic_id)
 		{
-			lua_pushliteral(L, "__luabind_class_map");
-			lua_rawget(L, LUA_REGISTRYINDEX);
-
-			class_map const& classes = *static_cast<class_map*>(lua_touserdata(L, -1));
-
-			lua_pop(L, 1);
+			class_map const& classes = get_state_context(L).classes;
 
 			class_rep* cls = classes.get(dynamic_id);
 
@@ -72,12 +45,19 @@ namespace luabind {
 				throw std::runtime_error("Trying to use unregistered class: " + std::string(typeid(P).name()));
 			}
 
-			object_rep* instance = push_new_instance(L, cls);
-
 			using value_type = typename std::remove_reference<P>::type;
 			using holder_type = pointer_holder<value_type>;
 
-			void* storage = instance->allocate(sizeof(holder_type));
+			// Only plain pointers to mutable objects share instances, the
+			// instance made for a const or owning pointer would not fit.
+			bool const identity = std::is_pointer<value_type>::value && !is_pointer_to_const<value_type>::value
+				&& cls->has_identity_map();
+
+			if(identity && cls->get_identity(L, dynamic.second))
+				return;
+
+			object_rep* instance = push_new_instance(L, cls, holder_storage_size<holder_type>());
+			void* storage = instance->allocate(sizeof(holder_type), alignof(holder_type));
 
 			try
 			{
@@ -91,6 +71,9 @@ namespace luabind {
 			}
 
 			instance->set_instance(static_cast<holder_type*>(storage));
+
+			if(identity)
+				cls->set_identity(L, dynamic.second, -1);
 		}
 
 
@@ -107,12 +90,11 @@ namespace luabind {
 					throw std::runtime_error("Trying to use unregistered class: " + std::string(typeid(pointee_type).name()));
 				}
 
-				object_rep* instance = push_new_instance(L, cls);
-
 				using value_type = typename std::remove_reference<ValueType>::type;
 				using holder_type = pointer_like_holder<value_type>;
 
-				void* storage = instance->allocate(sizeof(holder_type));
+				object_rep* instance = push_new_instance(L, cls, holder_storage_size<holder_type>());
+				void* storage = instance->allocate(sizeof(holder_type), alignof(holder_type));
 
 				try {
 					new (storage) holder_type(L, std::forward<ValueType>(val), dynamic.first, dynamic.second);
@@ -139,12 +121,11 @@ namespace luabind {
 				throw std::runtime_error("Trying to use unregistered class: " + std::string(typeid(ValueType).name()));
 			}
 
-			object_rep* instance = push_new_instance(L, cls);
-
 			using value_type = typename std::remove_reference<ValueType>::type;
 			using holder_type = value_holder<value_type>;
 
-			void* storage = instance->allocate(sizeof(holder_type));
+			object_rep* instance = push_new_instance(L, cls, holder_storage_size<holder_type>());
+			void* storage = instance->allocate(sizeof(holder_type), alignof(holder_type));
 
 			try {
 				new (storage) holder_type(L, std::forward<ValueType>(val));
@@ -28,8 +28,9 @@
 #include <luabind/detail/class_rep.hpp>
 #include <luabind/detail/instance_holder.hpp>
 #include <luabind/detail/ref.hpp>
-#include <type_traits>	// std::aligned_storage
+#include <cstddef>
 #include <cstdlib>
+#include <memory>	// std::align
 
 namespace luabind {
 	namespace detail {
@@ -39,24 +40,42 @@ namespace luabind {
 		// this class is allocated inside lua for each pointer.
 		// it contains the actual c++ object-pointer.
 		// it also tells if it is const or not.
+		// The userdata continues past the object_rep with storage for the
+		// holder, `buffer_size` bytes starting at instance_buffer_offset.
 		class LUABIND_API object_rep
 		{
 		public:
-			object_rep(instance_holder* instance, class_rep* crep);
+			object_rep(instance_holder* instance, class_rep* crep, std::size_t buffer_size);
 			~object_rep();
 
 			const class_rep* crep() const { return m_classrep; }
 			class_rep* crep() { return m_classrep; }
 
 			void set_instance(instance_holder* instance) { m_instance = instance; }
+			instance_holder const* get_holder() const { return m_instance; }
 
 			void add_dependency(lua_State* L, int index);
 
+			// True once fields were assigned to this instance from Lua, which
+			// then live in a table of its own.
+			bool has_own_members() const { return m_own_members; }
+			void set_own_members() { m_own_members = true; }
+
+			// Instances for references into this object, see cached_reference.
+			// get_child() pushes the one for pointee and returns true if it is
+			// still alive, add_child() remembers the instance at index without
+			// keeping it alive.
+			bool get_child(lua_State* L, void const* pointee, class_id id, bool is_const);
+			void add_child(lua_State* L, void const* pointee, int index);
+
 			std::pair<void*, int> get_instance(class_id target) const
 			{
 				if(m_instance == 0)
 					return std::pair<void*, int>(nullptr, -1);
-				return m_instance->get(m_classrep->casts(), target);
+				// Most often the exact type held is asked for, self in member calls.
+				if(target == m_instance->pointee_id())
+					return std::pair<void*, int>(m_instance->pointee(), 0);
+				return m_classrep->cast_instance(*m_instance, target);
 			}
 
 			bool is_const() const
@@ -70,37 +89,61 @@ namespace luabind {
 					m_instance->release();
 			}
 
-			void* allocate(std::size_t size)
-			{
-				if(size <= 32) {
-					return &m_instance_buffer;
-				}
-				else {
-					return std::malloc(size);
-				}
-
-			}
-
-			void deallocate(void* storage)
-			{
-				if(storage == &m_instance_buffer) {
-					return;
-				}
-				else {
-					std::free(storage);
-				}
-			}
+			void* allocate(std::size_t size, std::size_t alignment);
+			void deallocate(void* storage);
 
 		private:
 			object_rep(object_rep const&) = delete;
 			void operator=(object_rep const&) = delete;
 
+			char* buffer();
+
 			instance_holder* m_instance;
-			std::aligned_storage<32>::type m_instance_buffer;
+			unsigned int m_buffer_size;
+			bool m_own_members;
 			class_rep* m_classrep; // the class information about this object's type
 			detail::lua_reference m_dependency_ref; // reference to lua table holding dependency references
 		};
 
+		// The object_rep is followed by a tag identifying instances, and then
+		// by the holder storage.
+		std::size_t const instance_buffer_offset =
+			(sizeof(object_rep) + sizeof(void const*) + alignof(void*) - 1) & ~(alignof(void*) - 1);
+
+		// Lua only promises pointer alignment for userdata, so holders that
+		// need more get enough room to be aligned by hand.
+		template <class Holder>
+		constexpr std::size_t holder_storage_size()
+		{
+			return sizeof(Holder) + (alignof(Holder) > alignof(void*) ? alignof(Holder) - 1 : 0);
+		}
+
+		inline char* object_rep::buffer()
+		{
+			return reinterpret_cast<char*>(this) + instance_buffer_offset;
+		}
+
+		inline void* object_rep::allocate(std::size_t size, std::size_t alignment)
+		{
+			void* storage = buffer();
+			std::size_t space = m_buffer_size;
+
+			if(std::align(alignment, size, storage, space))
+				return storage;
+
+			return std::malloc(size);
+		}
+
+		inline void object_rep::deallocate(void* storage)
+		{
+			char* const p = static_cast<char*>(storage);
+
+			if(p >= buffer() && p < buffer() + m_buffer_size)
+				return;
+
+			std::free(storage);
+		}
+
 		template<class T>
 		struct delete_s
 		{
@@ -127,7 +170,11 @@ namespace luabind {
 
 		LUABIND_API object_rep* get_instance(lua_State* L, int index);
 		LUABIND_API void push_instance_metatable(lua_State* L);
-		LUABIND_API object_rep* push_new_instance(lua_State* L, class_rep* cls);
+		LUABIND_API object_rep* push_new_instance(lua_State* L, class_rep* cls, std::size_t holder_size = default_holder_storage_size);
+
+		// Whether the instance on top of the stack has a value for name of
+		// its own, in a slot or in its member table, hiding its class'.
+		LUABIND_API bool has_own_member(lua_State* L, char const* name);
 
 	}	// namespace detail
 
@@ -49,6 +49,24 @@ namespace luabind
 
 		struct converter_policy_has_postcall_tag {};
 
+		// Converters deriving from this tag score an argument by nothing but its
+		// Lua type and, for luabind instances, the holder type and dynamic class.
+		// Overload sets made only of such converters can cache their resolution.
+		struct shape_matched_converter_tag {};
+
+		// The Lua types an argument converter can match, one bit per LUA_T*
+		// constant. Converters declare them in a lua_types enum, any converter
+		// that does not is assumed to accept every type.
+		template< typename Converter, typename Enable = void >
+		struct converter_lua_types
+			: std::integral_constant< unsigned int, ~0u >
+		{};
+
+		template< typename Converter >
+		struct converter_lua_types< Converter, typename std::conditional< true, void, decltype(Converter::lua_types) >::type >
+			: std::integral_constant< unsigned int, Converter::lua_types >
+		{};
+
 	}
 
 	// A converter policy injector instructs the call mechanism to use a certain converter policy for
@@ -5,6 +5,12 @@
 #ifndef LUABIND_PROPERTY_081020_HPP
 # define LUABIND_PROPERTY_081020_HPP
 
+# include <new>
+# include <type_traits>
+# include <luabind/lua_include.hpp>
+# include <luabind/detail/inheritance.hpp>
+# include <luabind/detail/policy.hpp>
+
 namespace luabind {
 	namespace detail {
 
@@ -28,6 +34,73 @@ namespace luabind {
 			T Class::* mem_ptr;
 		};
 
+		// Members that get_instance_value and set_instance_value read and
+		// write in place, without calling the property's functions.
+		template <class T>
+		struct is_direct_member
+			: std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>
+		{};
+
+		// Kept in the third upvalue of a property for such a member. `set` is
+		// null for read-only members and returns false if the value doesn't
+		// convert, in which case the setter function is called instead.
+		struct member_accessor
+		{
+			using get_function = void(*)(lua_State* L, member_accessor const& self, void* instance);
+			using set_function = bool(*)(lua_State* L, member_accessor const& self, void* instance, int index);
+
+			class_id id;
+			get_function get;
+			set_function set;
+		};
+
+		template <class Class, class T, class D>
+		struct member_accessor_impl : member_accessor
+		{
+			using value_type = typename std::remove_const<D>::type;
+
+			static void get_(lua_State* L, member_accessor const& self, void* instance)
+			{
+				default_converter<value_type>().to_lua(L, static_cast<Class*>(instance)->*static_cast<member_accessor_impl const&>(self).mem_ptr);
+			}
+
+			static bool set_(lua_State* L, member_accessor const& self, void* instance, int index)
+			{
+				default_converter<value_type> c;
+
+				if(c.match(L, by_value<value_type>(), index) < 0)
+					return false;
+
+				static_cast<Class*>(instance)->*static_cast<member_accessor_impl const&>(self).mem_ptr = c.to_cpp(L, by_value<value_type>(), index);
+				return true;
+			}
+
+			D T::* mem_ptr;
+		};
+
+		template <class Impl>
+		member_accessor::set_function member_setter(std::true_type /*writable*/)
+		{
+			return &Impl::set_;
+		}
+
+		template <class Impl>
+		member_accessor::set_function member_setter(std::false_type /*writable*/)
+		{
+			return 0;
+		}
+
+		template <class Class, class T, class D, class Writable>
+		void push_member_accessor(lua_State* L, D T::* mem_ptr, Writable)
+		{
+			using impl = member_accessor_impl<Class, T, D>;
+			impl* accessor = new (lua_newuserdata(L, sizeof(impl))) impl;
+			accessor->id = registered_class<Class>::id;
+			accessor->get = &impl::get_;
+			accessor->set = member_setter<impl>(Writable());
+			accessor->mem_ptr = mem_ptr;
+		}
+
 	} // namespace detail
 } // namespace luabind
 
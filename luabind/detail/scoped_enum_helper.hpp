@@ -28,6 +28,7 @@
 #include <type_traits>
 
 #include <luabind/config.hpp>
+#include <luabind/lua_include.hpp>
 #include <luabind/detail/class_rep.hpp>
 
 /**
@@ -47,6 +48,19 @@ namespace luabind {
 
 		enum traits_test_enum { };
 
+		/**
+		 * storage for enum_ constants and the number type enum_converter goes through.
+		 *
+		 * @note Lua 5.3 added an integer subtype, so 64-bit enum values survive the trip unchanged
+		 */
+#if LUA_VERSION_NUM >= 503
+		using enum_value_type = lua_Integer;
+		using enum_number_type = lua_Integer;
+#else
+		using enum_value_type = int;
+		using enum_number_type = lua_Number;
+#endif
+
 		/** metafunction to discriminate between classic enums and C++11 scoped enums */
 		template <typename T>
 		using is_scoped_enum = std::integral_constant
@@ -128,7 +142,7 @@ namespace luabind {
 		template <typename T, typename LuaNumberType>
 		struct unchecked_enum_helper<T, LuaNumberType, std::enable_if_t<is_scoped_enum<T>::value>>
 		{
-			static constexpr int CastToLuaNumber(T v) noexcept
+			static constexpr LuaNumberType CastToLuaNumber(T v) noexcept
 			{
 				return static_cast<LuaNumberType>(static_cast<std::underlying_type_t<T>>(v));
 			}
@@ -0,0 +1,94 @@
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef LUABIND_DETAIL_STATE_CONTEXT_HPP
+# define LUABIND_DETAIL_STATE_CONTEXT_HPP
+
+# include <luabind/config.hpp>
+# include <luabind/lua_state_fwd.hpp>
+# include <luabind/detail/class_registry.hpp>
+# include <luabind/detail/inheritance.hpp>
+# include <typeinfo>
+# include <vector>
+
+namespace luabind {
+	namespace detail {
+
+		// The tables luabind keeps for a lua_State and all of its threads.
+		// Created by open() in a single userdata, which is kept in the
+		// registry under a lightuserdata key.
+		struct state_context
+		{
+			explicit state_context(lua_State* L)
+				: registry(L)
+			{}
+
+			// False if the class is registered, and neither it nor one of its
+			// bases was registered with a wrapper. Objects of such a class
+			// cannot be a wrap_base. C++ classes deriving from a wrapper must
+			// list the wrapped class among their bases.
+			bool may_be_wrapped(class_id id) const
+			{
+				return !classes.get(id) || (id < wrapped.size() && wrapped[id]);
+			}
+
+			void add_wrapped_class(class_id id)
+			{
+				if(id >= wrapped.size())
+					wrapped.resize(id + 1);
+				wrapped[id] = true;
+			}
+
+			class_registry registry;
+			class_id_map class_ids;
+			cast_graph casts;
+			class_map classes;
+			std::vector<bool> wrapped;
+		};
+
+		// Throws if luabind::open() has not been called on the state.
+		LUABIND_API state_context& get_state_context(lua_State* L);
+
+		template <class T>
+		std::pair<class_id, void*> get_dynamic_class_aux(class_id_map& class_ids, T const* p, std::true_type)
+		{
+# ifdef LUABIND_VTABLE_CACHE
+			void const* const vtable = *reinterpret_cast<void const* const*>(p);
+
+			if(class_id_map::vtable_entry const* e = class_ids.find_vtable(vtable))
+				return std::make_pair(e->id, (void*)((char const*)p + e->offset));
+# endif
+
+			class_id const id = class_ids.get_local(typeid(*p));
+			void* const dynamic_ptr = dynamic_cast<void*>(const_cast<T*>(p));
+
+# ifdef LUABIND_VTABLE_CACHE
+			class_ids.put_vtable(vtable, id, (char const*)dynamic_ptr - (char const*)p);
+# endif
+
+			return std::make_pair(id, dynamic_ptr);
+		}
+
+		template <class T>
+		std::pair<class_id, void*> get_dynamic_class_aux(class_id_map&, T const* p, std::false_type)
+		{
+			return std::make_pair(registered_class<T>::id, (void*)p);
+		}
+
+		template <class T>
+		std::pair<class_id, void*> get_dynamic_class(state_context& context, T* p)
+		{
+			return get_dynamic_class_aux(context.class_ids, p, std::is_polymorphic<T>());
+		}
+
+		template <class T>
+		std::pair<class_id, void*> get_dynamic_class(lua_State* L, T* p)
+		{
+			return get_dynamic_class(get_state_context(L), p);
+		}
+
+	} // namespace detail
+} // namespace luabind
+
+#endif // LUABIND_DETAIL_STATE_CONTEXT_HPP
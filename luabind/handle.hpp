@@ -30,7 +30,8 @@
 namespace luabind {
 
 	// A reference to a Lua value. Represents an entry in the
-	// registry table.
+	// registry table. Copies share the entry until one of them
+	// is replace()d.
 	class handle
 	{
 	public:
@@ -38,9 +39,11 @@ namespace luabind {
 		handle(lua_State* interpreter, int stack_index);
 		handle(lua_State* main, lua_State* interpreter, int stack_index);
 		handle(handle const& other);
+		handle(handle&& other) noexcept;
 		~handle();
 
 		handle& operator=(handle const& other);
+		handle& operator=(handle&& other) noexcept;
 		void swap(handle& other);
 
 		void push(lua_State* interpreter) const;
@@ -52,29 +55,42 @@ namespace luabind {
 	private:
 		lua_State* m_interpreter;
 		int m_index;
+		// The number of handles sharing the entry, allocated when
+		// the handle is first copied.
+		mutable int* m_count;
 	};
 
 	inline handle::handle()
-		: m_interpreter(0), m_index(LUA_NOREF)
+		: m_interpreter(0), m_index(LUA_NOREF), m_count(0)
 	{}
 
 	inline handle::handle(handle const& other)
-		: m_interpreter(other.m_interpreter), m_index(LUA_NOREF)
+		: m_interpreter(other.m_interpreter), m_index(other.m_index), m_count(0)
 	{
-		if(m_interpreter == 0) return;
-		lua_rawgeti(m_interpreter, LUA_REGISTRYINDEX, other.m_index);
-		m_index = luaL_ref(m_interpreter, LUA_REGISTRYINDEX);
+		// nil has no entry to share
+		if(m_interpreter == 0 || m_index == LUA_REFNIL) return;
+		if(!other.m_count) other.m_count = new int(1);
+		m_count = other.m_count;
+		++*m_count;
+	}
+
+	inline handle::handle(handle&& other) noexcept
+		: m_interpreter(other.m_interpreter), m_index(other.m_index), m_count(other.m_count)
+	{
+		other.m_interpreter = 0;
+		other.m_index = LUA_NOREF;
+		other.m_count = 0;
 	}
 
 	inline handle::handle(lua_State* interpreter, int stack_index)
-		: m_interpreter(interpreter), m_index(LUA_NOREF)
+		: m_interpreter(interpreter), m_index(LUA_NOREF), m_count(0)
 	{
 		lua_pushvalue(interpreter, stack_index);
 		m_index = luaL_ref(interpreter, LUA_REGISTRYINDEX);
 	}
 
 	inline handle::handle(lua_State* main, lua_State* interpreter, int stack_index)
-		: m_interpreter(main), m_index(LUA_NOREF)
+		: m_interpreter(main), m_index(LUA_NOREF), m_count(0)
 	{
 		lua_pushvalue(interpreter, stack_index);
 		m_index = luaL_ref(interpreter, LUA_REGISTRYINDEX);
@@ -82,6 +98,8 @@ namespace luabind {
 
 	inline handle::~handle()
 	{
+		if(m_count && --*m_count != 0) return;
+		delete m_count;
 		if(m_interpreter && m_index != LUA_NOREF) luaL_unref(m_interpreter, LUA_REGISTRYINDEX, m_index);
 	}
 
@@ -91,10 +109,17 @@ namespace luabind {
 		return *this;
 	}
 
+	inline handle& handle::operator=(handle&& other) noexcept
+	{
+		handle(std::move(other)).swap(*this);
+		return *this;
+	}
+
 	inline void handle::swap(handle& other)
 	{
 		std::swap(m_interpreter, other.m_interpreter);
 		std::swap(m_index, other.m_index);
+		std::swap(m_count, other.m_count);
 	}
 
 	inline void handle::push(lua_State* interpreter) const
@@ -109,6 +134,13 @@ namespace luabind {
 
 	inline void handle::replace(lua_State* interpreter, int stack_index)
 	{
+		// copies keep the old value
+		if(m_index == LUA_REFNIL || (m_count && *m_count > 1))
+		{
+			handle(m_interpreter, interpreter, stack_index).swap(*this);
+			return;
+		}
+
 		lua_pushvalue(interpreter, stack_index);
 		lua_rawseti(interpreter, LUA_REGISTRYINDEX, m_index);
 	}
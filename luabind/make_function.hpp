@@ -10,6 +10,7 @@
 #include <luabind/detail/call.hpp>
 #include <luabind/detail/deduce_signature.hpp>
 #include <luabind/detail/format_signature.hpp>
+#include <new>
 
 namespace luabind {
 
@@ -19,6 +20,11 @@ namespace luabind {
 		LUABIND_API void handle_exception_aux(lua_State* L);
 # endif
 
+		// Calls the overloads starting at f with the arguments on the stack,
+		// the way their closure would. Returns false with the error message
+		// on the stack, for the caller to raise.
+		LUABIND_API bool call_function_object(lua_State* L, function_object* f, int& results);
+
 		// MSVC complains about member being sensitive to alignment (C4121)
 		// when F is a pointer to member of a class with virtual bases.
 # ifdef _MSC_VER
@@ -30,7 +36,7 @@ namespace luabind {
 		struct function_object_impl : function_object
 		{
 			function_object_impl(F f)
-				: function_object(&entry_point), f(f)
+				: function_object(&entry_point, &single_entry_point, invoke_traits<Signature, InjectorList>::shape_matched), f(f)
 			{}
 
 			int call(lua_State* L, invoke_context& ctx) /*const*/
@@ -42,21 +48,45 @@ namespace luabind {
 #endif
 			}
 
+			int score(lua_State* L) const
+			{
+				return invoke_struct<InjectorList, Signature, F>::score(L);
+			}
+
+			int arity() const
+			{
+				return invoke_traits<Signature, InjectorList>::arity;
+			}
+
+			unsigned int argument_types(int index) const
+			{
+				return invoke_struct<InjectorList, Signature, F>::argument_types(index);
+			}
+
 			void format_signature(lua_State* L, char const* function) const
 			{
 				detail::format_signature(L, function, Signature());
 			}
 
-			static bool invoke_defer(lua_State* L, function_object_impl* impl, invoke_context& ctx, int& results)
+			// lua_error may longjmp, so it is raised only once the
+			// invoke_context inside call_function_object is gone.
+			static int entry_point(lua_State* L)
+			{
+				function_object_impl* impl = static_cast<function_object_impl*>(lua_touserdata(L, lua_upvalueindex(1)));
+				int results = 0;
+
+				if(!call_function_object(L, impl, results))
+					lua_error(L);
+
+				return results;
+			}
+
+			static bool single_invoke_defer(lua_State* L, function_object_impl* impl, bool& matched, int& results)
 			{
 				bool exception_caught = false;
 
 				try {
-#ifndef LUABIND_NO_INTERNAL_TAG_ARGUMENTS
-					results = invoke(L, *impl, ctx, impl->f, Signature(), InjectorList());
-#else
-					results = invoke<InjectorList, Signature>(L, *impl, ctx, impl->f);
-#endif
+					matched = try_invoke<InjectorList, Signature>(L, *impl, impl->f, results);
 				}
 				catch(...) {
 					exception_caught = true;
@@ -66,27 +96,25 @@ namespace luabind {
 				return exception_caught;
 			}
 
-			static int entry_point(lua_State* L)
+			// Skips overload resolution entirely, add_overload replaces this
+			// with entry_point once a second overload is attached.
+			static int single_entry_point(lua_State* L)
 			{
-				function_object_impl const* impl_const = *(function_object_impl const**)lua_touserdata(L, lua_upvalueindex(1));
-
-				// TODO: Can this be done differently?
-				function_object_impl* impl = const_cast<function_object_impl*>(impl_const);
-				invoke_context ctx;
+				function_object_impl* impl = static_cast<function_object_impl*>(lua_touserdata(L, lua_upvalueindex(1)));
+				bool matched = false;
 				int results = 0;
 
 # ifndef LUABIND_NO_EXCEPTIONS
-				bool exception_caught = invoke_defer(L, impl, ctx, results);
+				bool exception_caught = single_invoke_defer(L, impl, matched, results);
 				if(exception_caught) lua_error(L);
 # else
-#ifndef LUABIND_NO_INTERNAL_TAG_ARGUMENTS
-				results = invoke(L, *impl, ctx, impl->f, Signature(), InjectorList());
-#else
-				results = invoke<InjectorList, Signature>(L, *impl, ctx, impl->f);
-#endif
+				matched = try_invoke<InjectorList, Signature>(L, *impl, impl->f, results);
 # endif
-				if(!ctx) {
-					ctx.format_error(L, impl);
+				if(!matched) {
+					{
+						invoke_context ctx;
+						ctx.format_error(L, impl);
+					}
 					lua_error(L);
 				}
 
@@ -100,6 +128,7 @@ namespace luabind {
 #  pragma pack(pop)
 # endif
 
+		// Expects impl to live in the userdata on top of the stack.
 		LUABIND_API object make_function_aux(lua_State* L, function_object* impl);
 		LUABIND_API void add_overload(object const&, char const*, object const&);
 
@@ -108,7 +137,9 @@ namespace luabind {
 	template <class F, typename... SignatureElements, typename... PolicyInjectors >
 	object make_function(lua_State* L, F f, meta::type_list< SignatureElements... >, meta::type_list< PolicyInjectors... >)
 	{
-		return detail::make_function_aux(L, new detail::function_object_impl<F, meta::type_list< SignatureElements... >, meta::type_list< PolicyInjectors...> >(f));
+		using impl_type = detail::function_object_impl<F, meta::type_list< SignatureElements... >, meta::type_list< PolicyInjectors...> >;
+		void* storage = lua_newuserdata(L, sizeof(impl_type));
+		return detail::make_function_aux(L, new (storage) impl_type(f));
 	}
 
 	template <class F, typename... PolicyInjectors >
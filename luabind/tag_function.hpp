@@ -46,6 +46,12 @@ namespace luabind {
 		{
 			return invoke<PolicyList, Signature>(L, self, ctx, tagged.f);
 		}
+
+		template < typename PolicyList, typename Signature, typename F >
+		bool try_invoke(lua_State* L, function_object const& self, tagged_function<Signature, F> /*const*/& tagged, int& results)
+		{
+			return try_invoke<PolicyList, Signature>(L, self, tagged.f, results);
+		}
 #endif
 
 	} // namespace detail
@@ -5,6 +5,8 @@
 #ifndef LUABIND_TYPEID_081227_HPP
 # define LUABIND_TYPEID_081227_HPP
 
+# include <cstddef>
+# include <functional>
 # include <typeinfo>
 # include <luabind/detail/type_traits.hpp>
 
@@ -52,5 +54,20 @@ namespace luabind {
 
 } // namespace luabind
 
+namespace std {
+
+	// Allows type_id as the key of unordered containers. Equal type_infos
+	// have equal hash codes even when they are distinct objects.
+	template <>
+	struct hash<luabind::type_id>
+	{
+		std::size_t operator()(luabind::type_id const& x) const
+		{
+			return x.hash_code();
+		}
+	};
+
+} // namespace std
+
 #endif // LUABIND_TYPEID_081227_HPP
 
@@ -44,6 +44,11 @@ namespace luabind
 		// be popped)
 		LUABIND_API void do_call_member_selection(lua_State* L, char const* name);
 
+		// whether the self reference on the top of the stack has
+		// a function by that name defined in lua. The self
+		// reference is popped.
+		LUABIND_API bool is_member_overridden(lua_State* L, char const* name);
+
 		template<class R, typename PolicyList = meta::type_list<>, unsigned int... Indices, typename... Args>
 		R call_member_impl(lua_State* L, std::true_type /*void*/, meta::index_list<Indices...>, Args&&... args);
 
@@ -92,6 +97,17 @@ namespace luabind
 			return detail::call_member_impl<R>(L, std::is_void<R>(), meta::index_range<1, sizeof...(Args)+1>(), std::forward<Args>(args)...);
 		}
 
+		// true if lua overrides the virtual function name. When it
+		// does not, a wrapper can call the C++ implementation
+		// directly instead of going through call().
+		bool is_overridden(char const* name) const
+		{
+			lua_State* L = m_self.state();
+			m_self.get(L);
+			assert(!lua_isnil(L, -1));
+			return detail::is_member_overridden(L, name);
+		}
+
 	private:
 		wrapped_self_t m_self;
 	};
@@ -28,7 +28,9 @@
 #include <luabind/class.hpp>
 #include <luabind/nil.hpp>
 #include <luabind/detail/debug.hpp>
+#include <luabind/detail/state_context.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -61,7 +63,7 @@ namespace luabind {
 
 			const char* m_name;
 
-			mutable std::map<const char*, int, detail::ltstr> m_static_constants;
+			std::vector<std::pair<const char*, enum_value_type>> m_static_constants;
 
 			using base_desc = std::pair<type_id, cast_function>;
 			mutable std::vector<base_desc> m_bases;
@@ -71,6 +73,9 @@ namespace luabind {
 			class_id m_wrapper_id;
 			type_id  m_wrapper_type;
 			std::vector<cast_entry> m_casts;
+			std::size_t m_holder_size;
+			std::vector<char const*> m_slots;
+			bool m_identity_map;
 
 			scope m_scope;
 			scope m_members;
@@ -78,6 +83,8 @@ namespace luabind {
 		};
 
 		class_registration::class_registration(char const* name)
+			: m_holder_size(0)
+			, m_identity_map(false)
 		{
 			m_name = name;
 		}
@@ -112,11 +119,8 @@ namespace luabind {
 			// register this new type in the class registry
 			r->add_class(m_type, crep);
 
-			lua_pushstring(L, "__luabind_class_map");
-			lua_rawget(L, LUA_REGISTRYINDEX);
-			class_map& classes = *static_cast<class_map*>(
-				lua_touserdata(L, -1));
-			lua_pop(L, 1);
+			state_context& context = get_state_context(L);
+			class_map& classes = context.classes;
 
 			classes.put(m_id, crep);
 
@@ -125,11 +129,28 @@ namespace luabind {
 			if(has_wrapper)
 				classes.put(m_wrapper_id, crep);
 
-			crep->m_static_constants.swap(m_static_constants);
+			if(m_holder_size)
+				crep->set_holder_size(m_holder_size);
+
+			for(char const* name : m_slots)
+				crep->add_slot(L, name);
+
+			if(m_identity_map)
+				crep->enable_identity_map(L);
 
 			detail::class_registry* registry = detail::class_registry::get_registry(L);
 
 			crep->get_default_table(L);
+			for(auto const& constant : m_static_constants)
+			{
+				lua_pushstring(L, constant.first);
+#if LUA_VERSION_NUM >= 503
+				lua_pushinteger(L, constant.second);
+#else
+				lua_pushnumber(L, constant.second);
+#endif
+				lua_rawset(L, -3);
+			}
 			m_scope.register_(L);
 			m_default_members.register_(L);
 			lua_pop(L, 1);
@@ -138,15 +159,8 @@ namespace luabind {
 			m_members.register_(L);
 			lua_pop(L, 1);
 
-			lua_pushstring(L, "__luabind_cast_graph");
-			lua_gettable(L, LUA_REGISTRYINDEX);
-			cast_graph* const casts = static_cast<cast_graph*>(lua_touserdata(L, -1));
-			lua_pop(L, 1);
-
-			lua_pushstring(L, "__luabind_class_id_map");
-			lua_gettable(L, LUA_REGISTRYINDEX);
-			class_id_map* const class_ids = static_cast<class_id_map*>(lua_touserdata(L, -1));
-			lua_pop(L, 1);
+			cast_graph* const casts = &context.casts;
+			class_id_map* const class_ids = &context.class_ids;
 
 			class_ids->put(m_id, m_type);
 
@@ -168,7 +182,7 @@ namespace luabind {
 				base.pointer_offset = 0;
 				base.base = bcrep;
 
-				crep->add_base_class(base);
+				crep->add_base_class(L, base);
 
 				// copy base class table
 				crep->get_table(L);
@@ -220,6 +234,19 @@ namespace luabind {
 
 			}
 
+			// Objects of classes derived from a wrapped class may be wrappers.
+			bool wrapped = has_wrapper;
+			for(auto const& base_pair : m_bases)
+				wrapped = wrapped || context.may_be_wrapped(class_ids->get(base_pair.first));
+
+			if(wrapped) {
+				context.add_wrapped_class(m_id);
+				if(has_wrapper)
+					context.add_wrapped_class(m_wrapper_id);
+			}
+
+			crep->check_finalizer(L);
+
 			lua_settable(L, -3);
 		}
 
@@ -264,9 +291,9 @@ namespace luabind {
 			return m_registration->m_name;
 		}
 
-		void class_base::add_static_constant(const char* name, int val)
+		void class_base::add_static_constant(const char* name, enum_value_type val)
 		{
-			m_registration->m_static_constants[name] = val;
+			m_registration->m_static_constants.emplace_back(name, val);
 		}
 
 		void class_base::add_inner_scope(scope& s)
@@ -274,6 +301,21 @@ namespace luabind {
 			m_registration->m_scope.operator,(s);
 		}
 
+		void class_base::add_holder_size(std::size_t size)
+		{
+			m_registration->m_holder_size = std::max(m_registration->m_holder_size, size);
+		}
+
+		void class_base::add_slot(char const* name)
+		{
+			m_registration->m_slots.push_back(name);
+		}
+
+		void class_base::add_identity_map()
+		{
+			m_registration->m_identity_map = true;
+		}
+
 		void class_base::add_cast(
 			class_id src, class_id target, cast_function cast)
 		{
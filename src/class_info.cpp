@@ -108,7 +108,7 @@ namespace luabind {
 	{
 		detail::class_registry* reg = detail::class_registry::get_registry(L);
 
-		std::map<type_id, detail::class_rep*> const& classes = reg->get_classes();
+		detail::class_registry::class_map_type const& classes = reg->get_classes();
 
 		object result = newtable(L);
 		std::size_t index = 1;
@@ -29,10 +29,11 @@
 #include <luabind/detail/class_registry.hpp>  // for class_registry
 #include <luabind/detail/class_rep.hpp>  // for class_rep
 #include <luabind/detail/garbage_collector.hpp>  // for garbage_collector
+#include <luabind/detail/state_context.hpp>  // for get_state_context
 
 
 #include <cassert>                      // for assert
-#include <map>                          // for map, etc
+#include <unordered_map>                // for unordered_map
 #include <utility>                      // for pair
 
 namespace luabind {
@@ -93,31 +94,7 @@ namespace luabind {
 
 		class_registry* class_registry::get_registry(lua_State* L)
 		{
-
-#ifdef LUABIND_NOT_THREADSAFE
-
-			// if we don't have to be thread safe, we can keep a
-			// chache of the class_registry pointer without the
-			// need of a mutex
-			static lua_State* cache_key = 0;
-			static class_registry* registry_cache = 0;
-			if(cache_key == L) return registry_cache;
-
-#endif
-
-			lua_pushstring(L, "__luabind_classes");
-			lua_gettable(L, LUA_REGISTRYINDEX);
-			class_registry* p = static_cast<class_registry*>(lua_touserdata(L, -1));
-			lua_pop(L, 1);
-
-#ifdef LUABIND_NOT_THREADSAFE
-
-			cache_key = L;
-			registry_cache = p;
-
-#endif
-
-			return p;
+			return &get_state_context(L).registry;
 		}
 
 		void class_registry::add_class(type_id const& info, class_rep* crep)
@@ -130,7 +107,7 @@ namespace luabind {
 
 		class_rep* class_registry::find_class(type_id const& info) const
 		{
-			std::map<type_id, class_rep*>::const_iterator i(
+			class_map_type::const_iterator i(
 				m_classes.find(info));
 
 			if(i == m_classes.end()) return 0; // the type is not registered
@@ -25,10 +25,14 @@
 #include <luabind/lua_include.hpp>
 
 #include <luabind/detail/stack_utils.hpp>
+#include <luabind/detail/instance_holder.hpp>
 #include <luabind/detail/conversion_storage.hpp>
+#include <luabind/detail/state_context.hpp>
 #include <luabind/luabind.hpp>
 #include <luabind/exception_handler.hpp>
 #include <luabind/get_main_thread.hpp>
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #if LUA_VERSION_NUM < 502
@@ -56,7 +60,16 @@ luabind::detail::class_rep::class_rep(type_id const& type
 	: m_type(type)
 	, m_name(name)
 	, m_class_type(cpp_class)
+	, m_instance_index_resolved(false)
+	, m_may_have_finalizer(false)
 	, m_operator_cache(0)
+	, m_holder_size(default_holder_storage_size)
+	, m_slot_count(0)
+	, m_identity_map(false)
+	, m_init(0)
+	, m_init_cached(false)
+	, m_cast_source(unknown_class)
+	, m_cast_generation(0)
 {
 	shared_init(L);
 }
@@ -79,25 +92,39 @@ void luabind::detail::class_rep::shared_init(lua_State * L) {
 	lua_pushvalue(L, -1); // duplicate our user data
 	m_self_ref.set(L);
 
-	m_instance_metatable = (m_class_type == cpp_class) ? r->cpp_instance() : r->lua_instance();
-
-	lua_pushstring(L, "__luabind_cast_graph");
-	lua_gettable(L, LUA_REGISTRYINDEX);
-	m_casts = static_cast<cast_graph*>(lua_touserdata(L, -1));
+	lua_newtable(L);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, r->cpp_instance());
+	lua_pushnil(L);
+	while(lua_next(L, -2))
+	{
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, -5);
+	}
 	lua_pop(L, 1);
-
-	lua_pushstring(L, "__luabind_class_id_map");
-	lua_gettable(L, LUA_REGISTRYINDEX);
-	m_classes = static_cast<class_id_map*>(lua_touserdata(L, -1));
+	handle(L, -1).swap(m_instance_metatable);
 	lua_pop(L, 1);
 
+	state_context& context = get_state_context(L);
+	m_casts = &context.casts;
+	m_classes = &context.class_ids;
+
 }
 
 luabind::detail::class_rep::class_rep(lua_State* L, const char* name)
 	: m_type(typeid(null_type))
 	, m_name(name)
 	, m_class_type(lua_class)
+	, m_instance_index_resolved(false)
+	, m_may_have_finalizer(false)
 	, m_operator_cache(0)
+	, m_holder_size(default_holder_storage_size)
+	, m_slot_count(0)
+	, m_identity_map(false)
+	, m_init(0)
+	, m_init_cached(false)
+	, m_cast_source(unknown_class)
+	, m_cast_generation(0)
 {
 	shared_init(L);
 }
@@ -115,6 +142,51 @@ luabind::detail::class_rep::allocate(lua_State* L) const
 	return std::pair<void*, void*>(mem, (void*)0);
 }
 
+std::pair<void*, int>
+luabind::detail::class_rep::cast_instance(instance_holder const& holder, class_id target) const
+{
+	void* const p = holder.pointee();
+	class_id const src = holder.pointee_id();
+
+	// Only objects whose static type is their most derived type share offsets.
+	if(!p || src != holder.dynamic_id() || target == holder.holder_id())
+		return holder.get(casts(), target);
+
+	if(m_cast_generation != casts().generation())
+	{
+		m_cast_offsets.clear();
+		m_cast_generation = casts().generation();
+	}
+
+	if(m_cast_source != src)
+	{
+		if(m_cast_source != unknown_class)
+			return holder.get(casts(), target);
+		m_cast_source = src;
+	}
+
+	if(target >= m_cast_offsets.size())
+	{
+		cast_offset const unknown = { 0, -2 };
+		m_cast_offsets.resize(target + 1, unknown);
+	}
+
+	cast_offset& entry = m_cast_offsets[target];
+
+	if(entry.distance == -2)
+	{
+		std::pair<void*, int> result = casts().cast(p, src, target, src, p);
+		entry.offset = result.first ? static_cast<char*>(result.first) - static_cast<char*>(p) : 0;
+		entry.distance = result.second < 0 ? -1 : result.second;
+		return result;
+	}
+
+	if(entry.distance < 0)
+		return std::pair<void*, int>(nullptr, -1);
+
+	return std::pair<void*, int>(static_cast<char*>(p) + entry.offset, entry.distance);
+}
+
 namespace
 {
 
@@ -122,6 +194,30 @@ namespace
 
 } // namespace unnamed
 
+luabind::detail::function_object* luabind::detail::class_rep::init_function(lua_State* L)
+{
+	if(!m_init_cached)
+	{
+		m_init = 0;
+
+		get_table(L);
+		lua_pushliteral(L, "__init");
+		lua_gettable(L, -2);
+
+		if(is_luabind_function(L, -1))
+		{
+			lua_getupvalue(L, -1, 1);
+			m_init = static_cast<function_object*>(lua_touserdata(L, -1));
+			lua_pop(L, 1);
+		}
+
+		lua_pop(L, 2);
+		m_init_cached = true;
+	}
+
+	return m_init;
+}
+
 // this is called as metamethod __call on the class_rep.
 int luabind::detail::class_rep::constructor_dispatcher(lua_State* L)
 {
@@ -129,7 +225,21 @@ int luabind::detail::class_rep::constructor_dispatcher(lua_State* L)
 
 	int args = lua_gettop(L);
 
-	push_new_instance(L, cls);
+	push_new_instance(L, cls, cls->holder_size());
+
+	// Constructors bound from C++ are called directly, without going
+	// through lua_call. They don't use super.
+	if(function_object* init = cls->init_function(L))
+	{
+		lua_replace(L, 1);
+
+		int results;
+		if(!call_function_object(L, init, results))
+			lua_error(L);
+
+		lua_settop(L, 1);
+		return 1;
+	}
 
 	if(super_deprecation_disabled
 		&& cls->get_class_type() == class_rep::lua_class
@@ -164,7 +274,7 @@ int luabind::detail::class_rep::constructor_dispatcher(lua_State* L)
 	return 1;
 }
 
-void luabind::detail::class_rep::add_base_class(const luabind::detail::class_rep::base_info& binfo)
+void luabind::detail::class_rep::add_base_class(lua_State* L, const luabind::detail::class_rep::base_info& binfo)
 {
 	// If you hit this assert you are deriving from a type that is not registered
 	// in lua. That is, in the class_<> you are giving a baseclass that isn't registered.
@@ -175,10 +285,23 @@ void luabind::detail::class_rep::add_base_class(const luabind::detail::class_rep
 
 	class_rep* bcrep = binfo.base;
 
-	// import all static constants
-	for(const auto& scon : bcrep->m_static_constants) {
-		int& v = m_static_constants[scon.first];
-		v = scon.second;
+	if(bcrep->m_identity_map)
+		enable_identity_map(L);
+
+	// Lua classes are constructed by their base class' constructors.
+	if(m_class_type == lua_class)
+		m_holder_size = std::max(m_holder_size, bcrep->m_holder_size);
+
+	if(bcrep->m_slot_count)
+	{
+		bcrep->get_slot_table(L);
+		lua_pushnil(L);
+		while(lua_next(L, -2))
+		{
+			lua_pop(L, 1);
+			add_slot(L, lua_tostring(L, -1));
+		}
+		lua_pop(L, 1);
 	}
 
 	// also, save the baseclass info to be used for typecasts
@@ -232,10 +355,193 @@ int luabind::detail::class_rep::super_callback(lua_State* L)
 
 
 
+void luabind::detail::class_rep::get_instance_metatable(lua_State* L)
+{
+	m_instance_metatable.push(L);
+
+	if(m_instance_index_resolved)
+		return;
+
+	// Without properties or slots every member can be taken from the class
+	// table as it is, so the VM can look them up without calling into luabind.
+	bool has_property = m_slot_count != 0;
+
+	get_table(L);
+	lua_pushnil(L);
+	while(lua_next(L, -2))
+	{
+		has_property = has_property || lua_tocfunction(L, -1) == &property_tag;
+		lua_pop(L, 1);
+	}
+
+	if(has_property)
+	{
+		lua_pop(L, 1);
+	}
+	else
+	{
+		lua_pushliteral(L, "__index");
+		lua_insert(L, -2);
+		lua_rawset(L, -3);
+	}
+
+	m_instance_index_resolved = true;
+}
+
+void luabind::detail::class_rep::add_slot(lua_State* L, char const* name)
+{
+	if(!m_slot_count)
+	{
+		lua_newtable(L);
+		handle(L, -1).swap(m_slots);
+		lua_pop(L, 1);
+	}
+
+	m_slots.push(L);
+	lua_getfield(L, -1, name);
+
+	if(lua_isnil(L, -1))
+	{
+		lua_pushinteger(L, ++m_slot_count);
+		lua_setfield(L, -3, name);
+	}
+
+	lua_pop(L, 2);
+}
+
+void luabind::detail::class_rep::enable_identity_map(lua_State* L)
+{
+	if(m_identity_map)
+		return;
+
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushliteral(L, "__mode");
+	lua_pushliteral(L, "v");
+	lua_rawset(L, -3);
+	lua_setmetatable(L, -2);
+	handle(L, -1).swap(m_identities);
+	lua_pop(L, 1);
+
+	m_identity_map = true;
+}
+
+bool luabind::detail::class_rep::get_identity(lua_State* L, void const* p) const
+{
+	m_identities.push(L);
+	lua_pushlightuserdata(L, const_cast<void*>(p));
+	lua_rawget(L, -2);
+	lua_remove(L, -2);
+
+	// before Lua 5.2 collected instances stay in weak tables until
+	// their finalizer ran, destroy_instance() removes them then
+	object_rep* instance = get_instance(L, -1);
+
+	if(instance && instance->get_holder())
+		return true;
+
+	lua_pop(L, 1);
+	return false;
+}
+
+void luabind::detail::class_rep::set_identity(lua_State* L, void const* p, int index)
+{
+	lua_pushvalue(L, index);
+	m_identities.push(L);
+	lua_pushlightuserdata(L, const_cast<void*>(p));
+	lua_pushvalue(L, -3);
+	lua_rawset(L, -3);
+	lua_pop(L, 2);
+}
+
+void luabind::detail::class_rep::remove_identity(lua_State* L, void const* p, int index)
+{
+	m_identities.push(L);
+	lua_pushlightuserdata(L, const_cast<void*>(p));
+	lua_rawget(L, -2);
+
+	if(lua_rawequal(L, -1, index))
+	{
+		lua_pop(L, 1);
+		lua_pushlightuserdata(L, const_cast<void*>(p));
+		lua_pushnil(L);
+		lua_rawset(L, -3);
+		lua_pop(L, 1);
+	}
+	else
+	{
+		lua_pop(L, 2);
+	}
+}
+
+luabind::detail::class_rep::member_override const*
+luabind::detail::class_rep::find_member_override(lua_State* L, char const* name)
+{
+	for(auto const& entry : m_overrides)
+	{
+		if(entry.name == name)
+			return &entry;
+	}
+
+	m_table.push(L);
+	lua_pushstring(L, name);
+	lua_rawget(L, -2);
+
+	if(lua_tocfunction(L, -1) == &property_tag)
+	{
+		lua_pop(L, 2);
+		return 0;
+	}
+
+	bool const overridden = !lua_isnil(L, -1) && !is_luabind_function(L, -1);
+
+	if(is_luabind_function(L, -1))
+	{
+		// not overridden by lua, call the default implementation
+		m_default_table.push(L);
+		lua_pushstring(L, name);
+		lua_rawget(L, -2);
+		lua_replace(L, -3);
+		lua_pop(L, 1);
+	}
+
+	m_overrides.push_back(member_override{ name, overridden, handle(L, -1) });
+	lua_pop(L, 2);
+	return &m_overrides.back();
+}
+
+void luabind::detail::class_rep::check_finalizer(lua_State* L)
+{
+	m_table.push(L);
+	lua_pushliteral(L, "__finalize");
+	lua_rawget(L, -2);
+	if(!lua_isnil(L, -1))
+		m_may_have_finalizer = true;
+	lua_pop(L, 2);
+}
+
+void luabind::detail::class_rep::use_instance_index_function(lua_State* L)
+{
+	m_instance_metatable.push(L);
+	lua_pushliteral(L, "__index");
+	lua_rawgeti(L, LUA_REGISTRYINDEX, class_registry::get_registry(L)->cpp_instance());
+	lua_pushliteral(L, "__index");
+	lua_rawget(L, -2);
+	lua_replace(L, -2);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
 int luabind::detail::class_rep::lua_settable_dispatcher(lua_State* L)
 {
 	class_rep* crep = static_cast<class_rep*>(lua_touserdata(L, 1));
 
+	if(crep->m_instance_index_resolved && lua_tocfunction(L, 3) == &property_tag)
+		crep->use_instance_index_function(L);
+
+	if(lua_type(L, 2) == LUA_TSTRING && std::strcmp(lua_tostring(L, 2), "__finalize") == 0)
+		crep->m_may_have_finalizer = true;
+
 	// get first table
 	crep->get_table(L);
 
@@ -252,6 +558,8 @@ int luabind::detail::class_rep::lua_settable_dispatcher(lua_State* L)
 	lua_rawset(L, -3);
 
 	crep->m_operator_cache = 0; // invalidate cache
+	crep->m_init_cached = false;
+	crep->m_overrides.clear();
 
 	return 0;
 }
@@ -272,24 +580,10 @@ int luabind::detail::class_rep::static_class_gettable(lua_State* L)
 	if(!lua_isnil(L, -1)) return 1;
 	else lua_pop(L, 2);
 
-	const char* key = lua_tostring(L, 2);
-
-	if(std::strlen(key) != lua_rawlen(L, 2))
-	{
-		lua_pushnil(L);
-		return 1;
-	}
-
-	std::map<const char*, int, ltstr>::const_iterator j = crep->m_static_constants.find(key);
-
-	if(j != crep->m_static_constants.end())
-	{
-		lua_pushnumber(L, j->second);
-		return 1;
-	}
-
 #ifndef LUABIND_NO_ERROR_CHECKING
 
+	const char* key = lua_tostring(L, 2);
+
 	lua_pushfstring(L, "no static '%s' in class '%s'", key, crep->name());
 	lua_error(L);
 
@@ -353,10 +647,38 @@ void luabind::detail::class_rep::cache_operators(lua_State* L)
 
 		if(lua_isfunction(L, -1)) m_operator_cache |= 1 << (i + 1);
 
+		m_operators[i] = 0;
+
+		// a slot of the same name would take precedence
+		bool slot = false;
+
+		if(m_slot_count)
+		{
+			get_slot_table(L);
+			lua_getfield(L, -1, get_operator_name(i));
+			slot = !lua_isnil(L, -1);
+			lua_pop(L, 2);
+		}
+
+		if(!slot && is_luabind_function(L, -1))
+		{
+			lua_getupvalue(L, -1, 1);
+			m_operators[i] = static_cast<function_object*>(lua_touserdata(L, -1));
+			lua_pop(L, 1);
+		}
+
 		lua_pop(L, 2);
 	}
 }
 
+luabind::detail::function_object* luabind::detail::class_rep::operator_function(lua_State* L, int id)
+{
+	if((m_operator_cache & 0x1) == 0)
+		cache_operators(L);
+
+	return m_operators[id];
+}
+
 bool luabind::detail::class_rep::has_operator_in_lua(lua_State* L, int id)
 {
 	if((m_operator_cache & 0x1) == 0)
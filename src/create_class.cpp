@@ -91,7 +91,7 @@ namespace luabind {
 
 			binfo.pointer_offset = 0;
 			binfo.base = base;
-			crep->add_base_class(binfo);
+			crep->add_base_class(L, binfo);
 
 			// copy base class members
 
@@ -8,6 +8,10 @@
 #include <luabind/make_function.hpp>
 #include <luabind/detail/conversion_policies/conversion_policies.hpp>
 #include <luabind/detail/object.hpp>
+#include <luabind/detail/object_rep.hpp>
+#include <luabind/detail/instance_holder.hpp>
+#include <typeinfo>
+#include <vector>
 
 namespace luabind {
 	namespace detail {
@@ -16,14 +20,17 @@ namespace luabind {
 
 			int function_destroy(lua_State* L)
 			{
-				function_object* fn = *(function_object**)lua_touserdata(L, 1);
-				delete fn;
+				function_object* fn = static_cast<function_object*>(lua_touserdata(L, 1));
+				fn->~function_object();
 				return 0;
 			}
 
+			// The address of this is the registry key of the function metatable.
+			char function_metatable_key = 0;
+
 			void push_function_metatable(lua_State* L)
 			{
-				lua_pushstring(L, "luabind.function");
+				lua_pushlightuserdata(L, &function_metatable_key);
 				lua_rawget(L, LUA_REGISTRYINDEX);
 
 				if(lua_istable(L, -1))
@@ -37,7 +44,7 @@ namespace luabind {
 				lua_pushcclosure(L, &function_destroy, 0);
 				lua_rawset(L, -3);
 
-				lua_pushstring(L, "luabind.function");
+				lua_pushlightuserdata(L, &function_metatable_key);
 				lua_pushvalue(L, -2);
 				lua_rawset(L, LUA_REGISTRYINDEX);
 			}
@@ -48,6 +55,304 @@ namespace luabind {
 
 		} // namespace unnamed
 
+		// The properties of the arguments on the stack that shape matched
+		// converters base their score on.
+		struct overload_shape
+		{
+			enum { max_arguments = 8 };
+
+			struct argument
+			{
+				int type;
+				std::type_info const* holder;
+				class_id dynamic_id;
+
+				bool operator==(argument const& other) const
+				{
+					return type == other.type && holder == other.holder && dynamic_id == other.dynamic_id;
+				}
+			};
+
+			bool compute(lua_State* L)
+			{
+				arguments = lua_gettop(L);
+				if(arguments > max_arguments)
+					return false;
+
+				for(int i = 0; i < arguments; ++i)
+				{
+					argument& arg = args[i];
+					arg.type = lua_type(L, i + 1);
+					arg.holder = 0;
+					arg.dynamic_id = 0;
+
+					if(arg.type != LUA_TUSERDATA)
+						continue;
+
+					if(object_rep* obj = get_instance(L, i + 1))
+					{
+						if(instance_holder const* holder = obj->get_holder())
+						{
+							arg.holder = &typeid(*holder);
+							arg.dynamic_id = holder->dynamic_id();
+						}
+					}
+				}
+
+				return true;
+			}
+
+			bool operator==(overload_shape const& other) const
+			{
+				if(arguments != other.arguments)
+					return false;
+				for(int i = 0; i < arguments; ++i)
+				{
+					if(!(args[i] == other.args[i]))
+						return false;
+				}
+				return true;
+			}
+
+			int arguments;
+			argument args[max_arguments];
+		};
+
+		// Remembers which overload won the resolution for the last few argument
+		// shapes seen by a chain. Entries are replaced round robin.
+		struct overload_cache
+		{
+			enum { size = 4 };
+
+			overload_cache()
+				: used(0), replace(0)
+			{}
+
+			function_object* find(overload_shape const& shape) const
+			{
+				for(int i = 0; i < used; ++i)
+				{
+					if(entries[i].shape == shape)
+						return entries[i].winner;
+				}
+				return 0;
+			}
+
+			void insert(overload_shape const& shape, function_object* winner)
+			{
+				int index = used < size ? used++ : replace++ % size;
+				entries[index].shape = shape;
+				entries[index].winner = winner;
+			}
+
+			struct entry
+			{
+				overload_shape shape;
+				function_object* winner;
+			};
+
+			entry entries[size];
+			int used;
+			int replace;
+		};
+
+		// Splits an overload chain by arity and then by the Lua type of the first
+		// argument that tells the overloads of that arity apart, so that a call
+		// only scores the overloads that can accept its arguments.
+		struct overload_tree
+		{
+			enum { type_count = LUA_TTHREAD + 1 };
+
+			struct candidate
+			{
+				function_object* overload;
+				// True if no other overload in the same list accepts the Lua
+				// types this one does at every argument, so a perfect match for
+				// it cannot be tied.
+				bool exclusive;
+			};
+
+			typedef std::vector<candidate> candidate_list;
+
+			struct node
+			{
+				int arity;
+				// The stack index switched on, 0 if no argument tells the
+				// overloads apart.
+				int index;
+				candidate_list all;
+				candidate_list by_type[type_count];
+			};
+
+			explicit overload_tree(function_object* overloads)
+			{
+				for(function_object* f = overloads; f != 0; f = f->next)
+				{
+					node* n = find(f->arity());
+					if(!n)
+					{
+						nodes.push_back(node());
+						n = &nodes.back();
+						n->arity = f->arity();
+						n->index = 0;
+					}
+					candidate c = { f, false };
+					n->all.push_back(c);
+				}
+
+				for(node& n : nodes)
+				{
+					for(int index = 1; index <= n.arity && n.index == 0; ++index)
+					{
+						for(int type = 0; type < type_count; ++type)
+						{
+							candidate_list& bucket = n.by_type[type];
+							for(candidate const& c : n.all)
+							{
+								if(c.overload->argument_types(index) & (1u << type))
+									bucket.push_back(c);
+							}
+							if(bucket.size() < n.all.size())
+								n.index = index;
+						}
+
+						if(n.index == 0)
+						{
+							for(auto& bucket : n.by_type)
+								bucket.clear();
+						}
+					}
+
+					mark_exclusive(n.all, n.arity);
+					for(auto& bucket : n.by_type)
+						mark_exclusive(bucket, n.arity);
+				}
+			}
+
+			// Two overloads can only match the same arguments if the Lua types
+			// they accept overlap at every argument.
+			static bool disjoint(function_object const* a, function_object const* b, int arity)
+			{
+				for(int index = 1; index <= arity; ++index)
+				{
+					if((a->argument_types(index) & b->argument_types(index)) == 0)
+						return true;
+				}
+				return false;
+			}
+
+			static void mark_exclusive(candidate_list& candidates, int arity)
+			{
+				for(candidate& c : candidates)
+				{
+					c.exclusive = true;
+					for(candidate const& other : candidates)
+					{
+						if(&other != &c && !disjoint(c.overload, other.overload, arity))
+						{
+							c.exclusive = false;
+							break;
+						}
+					}
+				}
+			}
+
+			node* find(int arity)
+			{
+				for(node& n : nodes)
+				{
+					if(n.arity == arity)
+						return &n;
+				}
+				return 0;
+			}
+
+			int call(lua_State* L, invoke_context& ctx)
+			{
+				node* n = find(lua_gettop(L));
+				if(!n)
+					return 0;
+
+				candidate_list const* candidates = &n->all;
+				if(n->index != 0)
+				{
+					int type = lua_type(L, n->index);
+					if(type >= 0 && type < type_count)
+						candidates = &n->by_type[type];
+				}
+
+				if(candidates->empty())
+					return 0;
+				if(candidates->size() == 1)
+					return candidates->front().overload->call(L, ctx);
+
+				// A perfect match ends the search only when no other candidate
+				// could tie with it, otherwise ties must still be reported as
+				// ambiguous.
+				for(candidate const& c : *candidates)
+				{
+					int score = c.overload->score(L);
+					ctx.record(c.overload, score);
+					if(score == 0 && c.exclusive)
+						break;
+				}
+
+				if(!ctx)
+					return 0;
+				return const_cast<function_object*>(ctx.candidates[0])->call(L, ctx);
+			}
+
+			std::vector<node> nodes;
+		};
+
+		function_object::~function_object()
+		{
+			delete cache;
+			delete tree;
+		}
+
+		void function_object::build_tree()
+		{
+			delete tree;
+			tree = next ? new overload_tree(this) : 0;
+		}
+
+		void function_object::invalidate_cache()
+		{
+			delete cache;
+			cache = 0;
+		}
+
+		int function_object::dispatch(lua_State* L, invoke_context& ctx)
+		{
+			if(!next)
+				return call(L, ctx);
+
+			overload_shape shape;
+			bool const cacheable = shape_matched && shape.compute(L);
+
+			if(cacheable && cache)
+			{
+				if(function_object* winner = cache->find(shape))
+				{
+					int results = winner->call(L, ctx);
+					if(ctx)
+						return results;
+				}
+			}
+
+			int results = tree->call(L, ctx);
+
+			if(cacheable && ctx)
+			{
+				if(!cache)
+					cache = new overload_cache;
+				cache->insert(shape, const_cast<function_object*>(ctx.candidates[0]));
+			}
+
+			return results;
+		}
+
 		LUABIND_API bool is_luabind_function(lua_State* L, int index)
 		{
 			if(!lua_getupvalue(L, index, 2))
@@ -57,6 +362,33 @@ namespace luabind {
 			return result;
 		}
 
+		LUABIND_API bool call_function_object(lua_State* L, function_object* f, int& results)
+		{
+			invoke_context ctx;
+
+#ifndef LUABIND_NO_EXCEPTIONS
+			try
+			{
+				results = f->dispatch(L, ctx);
+			}
+			catch(...)
+			{
+				handle_exception_aux(L);
+				return false;
+			}
+#else
+			results = f->dispatch(L, ctx);
+#endif
+
+			if(!ctx)
+			{
+				ctx.format_error(L, f);
+				return false;
+			}
+
+			return true;
+		}
+
 		namespace
 		{
 
@@ -73,15 +405,29 @@ namespace luabind {
 		LUABIND_API void add_overload(
 			object const& context, char const* name, object const& fn)
 		{
-			function_object* f = *touserdata<function_object*>(std::get<1>(getupvalue(fn, 1)));
+			function_object* f = touserdata<function_object>(std::get<1>(getupvalue(fn, 1)));
 			f->name = name;
 
 			if(object overloads = context[name])
 			{
 				if(is_luabind_function(overloads) && is_luabind_function(fn))
 				{
-					f->next = *touserdata<function_object*>(std::get<1>(getupvalue(overloads, 1)));
+					f->next = touserdata<function_object>(std::get<1>(getupvalue(overloads, 1)));
 					f->keepalive = overloads;
+					f->shape_matched = f->shape_matched && f->next->shape_matched;
+					f->invalidate_cache();
+					f->build_tree();
+
+					// fn was made with the entry point for lone overloads, give
+					// the chain a closure over the same upvalues that resolves.
+					lua_State* L = fn.interpreter();
+					fn.push(L);
+					lua_getupvalue(L, -1, 1);
+					lua_getupvalue(L, -2, 2);
+					lua_pushcclosure(L, f->entry, 2);
+					context[name] = object(from_stack(L, -1));
+					lua_pop(L, 2);
+					return;
 				}
 			}
 
@@ -90,13 +436,11 @@ namespace luabind {
 
 		LUABIND_API object make_function_aux(lua_State* L, function_object* impl)
 		{
-			void* storage = lua_newuserdata(L, sizeof(function_object*));
 			push_function_metatable(L);
-			*(function_object**)storage = impl;
 			lua_setmetatable(L, -2);
 
 			lua_pushlightuserdata(L, &function_tag);
-			lua_pushcclosure(L, impl->entry, 2);
+			lua_pushcclosure(L, impl->next || !impl->single_entry ? impl->entry : impl->single_entry, 2);
 			stack_pop pop(L, 1);
 
 			return object(from_stack(L, -1));
@@ -131,7 +475,7 @@ namespace luabind {
 				{
 					if(i != 0)
 						lua_pushstring(L, "\n");
-					candidates[i]->format_signature(L, function_name);
+					candidate(i)->format_signature(L, function_name);
 				}
 				lua_concat(L, lua_gettop(L) - stacksize);
 			}
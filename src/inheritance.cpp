@@ -4,11 +4,11 @@
 
 #define LUABIND_BUILDING
 
+#include <algorithm>
 #include <limits>
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <queue>
-#include <vector>
 #include <luabind/typeid.hpp>
 #include <luabind/detail/inheritance.hpp>
 
@@ -43,10 +43,14 @@ namespace luabind {
 
 				class_id id;
 				std::vector<edge> edges;
+				// Vertices with an edge to this one.
+				std::vector<class_id> sources;
 			};
 
 			using cache_entry = std::pair<std::ptrdiff_t, int>;
 
+			// Open addressing table of cast results, with linear probing. A
+			// hit costs one hash and usually a single probe.
 			class cache
 			{
 			public:
@@ -56,32 +60,146 @@ namespace luabind {
 				cache_entry get(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset) const;
 
 				void put(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset, std::ptrdiff_t offset, int distance);
-				void invalidate();
+
+				// Drops the entries with a source in `sources` and a target in
+				// `targets`, both indexed by class id.
+				void invalidate(std::vector<bool> const& sources, std::vector<bool> const& targets);
+
+				bool empty() const
+				{
+					return m_size == 0;
+				}
 
 			private:
-				using key_type = std::tuple<class_id, class_id, class_id, std::ptrdiff_t>;
-				using map_type = std::map<key_type, cache_entry>;
-				map_type m_cache;
+				struct slot
+				{
+					class_id src = unknown_class;
+					class_id target;
+					class_id dynamic_id;
+					std::ptrdiff_t object_offset;
+					cache_entry entry;
+				};
+
+				std::size_t find(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset) const;
+				void rehash(std::size_t capacity);
+
+				std::vector<slot> m_slots;
+				std::size_t m_size = 0;
 			};
 
 			constexpr std::ptrdiff_t cache::unknown;
 			constexpr std::ptrdiff_t cache::invalid;
 
+			std::size_t hash_key(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset)
+			{
+				std::size_t h = src;
+				h = h * 0x9e3779b1u + target;
+				h = h * 0x9e3779b1u + dynamic_id;
+				h = h * 0x9e3779b1u + static_cast<std::size_t>(object_offset);
+				return h ^ (h >> 16);
+			}
+
+			// Returns the slot holding the key, or the empty slot where it
+			// belongs. Requires a table that is not full.
+			std::size_t cache::find(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset) const
+			{
+				std::size_t const mask = m_slots.size() - 1;
+				std::size_t i = hash_key(src, target, dynamic_id, object_offset) & mask;
+
+				for(;; i = (i + 1) & mask)
+				{
+					slot const& s = m_slots[i];
+					if(s.src == unknown_class)
+						return i;
+					if(s.src == src && s.target == target && s.dynamic_id == dynamic_id && s.object_offset == object_offset)
+						return i;
+				}
+			}
+
 			cache_entry cache::get(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset) const
 			{
-				map_type::const_iterator i = m_cache.find(
-					key_type(src, target, dynamic_id, object_offset));
-				return i != m_cache.end() ? i->second : cache_entry(unknown, -1);
+				if(m_size == 0)
+					return cache_entry(unknown, -1);
+				slot const& s = m_slots[find(src, target, dynamic_id, object_offset)];
+				return s.src != unknown_class ? s.entry : cache_entry(unknown, -1);
 			}
 
 			void cache::put(class_id src, class_id target, class_id dynamic_id, std::ptrdiff_t object_offset, std::ptrdiff_t offset, int distance)
 			{
-				m_cache.insert(std::make_pair(key_type(src, target, dynamic_id, object_offset), cache_entry(offset, distance)));
+				if((m_size + 1) * 2 > m_slots.size())
+					rehash(m_slots.empty() ? 64 : m_slots.size() * 2);
+
+				slot& s = m_slots[find(src, target, dynamic_id, object_offset)];
+				if(s.src == unknown_class)
+					++m_size;
+
+				s.src = src;
+				s.target = target;
+				s.dynamic_id = dynamic_id;
+				s.object_offset = object_offset;
+				s.entry = cache_entry(offset, distance);
 			}
 
-			void cache::invalidate()
+			void cache::rehash(std::size_t capacity)
 			{
-				m_cache.clear();
+				std::vector<slot> old(capacity);
+				old.swap(m_slots);
+
+				for(auto const& s : old)
+				{
+					if(s.src != unknown_class)
+						m_slots[find(s.src, s.target, s.dynamic_id, s.object_offset)] = s;
+				}
+			}
+
+			void cache::invalidate(std::vector<bool> const& sources, std::vector<bool> const& targets)
+			{
+				std::size_t const size = m_size;
+
+				for(auto& s : m_slots)
+				{
+					if(s.src != unknown_class && s.src < sources.size() && sources[s.src]
+						&& s.target < targets.size() && targets[s.target])
+					{
+						s.src = unknown_class;
+						--m_size;
+					}
+				}
+
+				// Removed slots may break probe sequences, so the survivors are
+				// placed again.
+				if(m_size != size)
+					rehash(m_slots.size());
+			}
+
+			// Marks every vertex reachable from `start`, following edges
+			// forward or backward.
+			std::vector<bool> reachable(std::vector<vertex> const& vertices, class_id start, bool backward)
+			{
+				std::vector<bool> visited(vertices.size(), false);
+				std::vector<class_id> stack(1, start);
+				visited[start] = true;
+
+				while(!stack.empty())
+				{
+					vertex const& v = vertices[stack.back()];
+					stack.pop_back();
+
+					auto visit = [&](class_id id) {
+						if(!visited[id])
+						{
+							visited[id] = true;
+							stack.push_back(id);
+						}
+					};
+
+					if(backward)
+						for(auto id : v.sources) visit(id);
+					else
+						for(auto const& e : v.edges) visit(e.target);
+				}
+
+				return visited;
 			}
 
 		} // namespace anonymous
@@ -94,9 +212,15 @@ namespace luabind {
 				, class_id dynamic_id, void const* dynamic_ptr) const;
 			void insert(class_id src, class_id target, cast_function cast);
 
+			std::size_t generation() const
+			{
+				return m_generation;
+			}
+
 		private:
 			std::vector<vertex> m_vertices;
 			mutable cache m_cache;
+			std::size_t m_generation = 0;
 		};
 
 		namespace
@@ -192,7 +316,20 @@ namespace luabind {
 			if(i == edges.end() || i->target != target)
 			{
 				edges.insert(i, edge(target, cast));
-				m_cache.invalidate();
+				m_vertices[target].sources.push_back(src);
+
+				// Only casts that can take the new edge may have changed: those
+				// starting where `src` can be reached from, and ending where
+				// `target` leads to.
+				if(!m_cache.empty())
+				{
+					m_cache.invalidate(
+						reachable(m_vertices, src, true)
+						, reachable(m_vertices, target, false)
+					);
+				}
+
+				++m_generation;
 			}
 		}
 
@@ -206,6 +343,11 @@ namespace luabind {
 			m_impl->insert(src, target, cast);
 		}
 
+		std::size_t cast_graph::generation() const
+		{
+			return m_impl->generation();
+		}
+
 		cast_graph::cast_graph()
 			: m_impl(new impl)
 		{}
@@ -215,7 +357,7 @@ namespace luabind {
 
 		LUABIND_API class_id allocate_class_id(type_id const& cls)
 		{
-			using map_type = std::map<type_id, class_id>;
+			using map_type = std::unordered_map<type_id, class_id>;
 
 			static map_type registered;
 			static class_id id = 0;
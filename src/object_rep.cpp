@@ -24,18 +24,24 @@
 
 #include <luabind/detail/object_rep.hpp>
 #include <luabind/detail/class_rep.hpp>
+#include <luabind/detail/class_registry.hpp>
+#include <luabind/detail/property.hpp>
+#include <luabind/function.hpp>
 
 #if LUA_VERSION_NUM < 502
 # define lua_getuservalue lua_getfenv
 # define lua_setuservalue lua_setfenv
+# define lua_rawlen lua_objlen
 #endif
 
 namespace luabind {
 	namespace detail {
 
 		// dest is a function that is called to delete the c++ object this struct holds
-		object_rep::object_rep(instance_holder* instance, class_rep* crep)
+		object_rep::object_rep(instance_holder* instance, class_rep* crep, std::size_t buffer_size)
 			: m_instance(instance)
+			, m_buffer_size(static_cast<unsigned int>(buffer_size))
+			, m_own_members(false)
 			, m_classrep(crep)
 		{
 		}
@@ -63,24 +69,122 @@ namespace luabind {
 			lua_pop(L, 1);
 		}
 
-		int destroy_instance(lua_State* L)
+		namespace
 		{
-			object_rep* instance = static_cast<object_rep*>(lua_touserdata(L, 1));
+			// key of the child table in the dependency table
+			char const child_table_tag = 0;
+		}
+
+		bool object_rep::get_child(lua_State* L, void const* pointee, class_id id, bool is_const)
+		{
+			if(!m_dependency_ref.is_valid())
+				return false;
 
-			lua_pushstring(L, "__finalize");
-			lua_gettable(L, 1);
+			m_dependency_ref.get(L);
+			lua_pushlightuserdata(L, const_cast<char*>(&child_table_tag));
+			lua_rawget(L, -2);
 
 			if(lua_isnil(L, -1))
 			{
+				lua_pop(L, 2);
+				return false;
+			}
+
+			lua_pushlightuserdata(L, const_cast<void*>(pointee));
+			lua_rawget(L, -2);
+
+			object_rep* child = luabind::detail::get_instance(L, -1);
+
+			if(child && child->is_const() == is_const && child->get_instance(id).first == pointee)
+			{
+				lua_replace(L, -3);
 				lua_pop(L, 1);
+				return true;
 			}
-			else
+
+			lua_pop(L, 3);
+			return false;
+		}
+
+		void object_rep::add_child(lua_State* L, void const* pointee, int index)
+		{
+			if(index < 0)
+				index += lua_gettop(L) + 1;
+
+			if(!m_dependency_ref.is_valid())
 			{
-				lua_pushvalue(L, 1);
-				lua_call(L, 1, 0);
+				lua_newtable(L);
+				m_dependency_ref.set(L);
 			}
+			m_dependency_ref.get(L);
+
+			lua_pushlightuserdata(L, const_cast<char*>(&child_table_tag));
+			lua_rawget(L, -2);
+
+			if(lua_isnil(L, -1))
+			{
+				lua_pop(L, 1);
+
+				// weak values, the table is its own metatable
+				lua_newtable(L);
+				lua_pushliteral(L, "v");
+				lua_setfield(L, -2, "__mode");
+				lua_pushvalue(L, -1);
+				lua_setmetatable(L, -2);
+
+				lua_pushlightuserdata(L, const_cast<char*>(&child_table_tag));
+				lua_pushvalue(L, -2);
+				lua_rawset(L, -4);
+			}
+
+			lua_pushlightuserdata(L, const_cast<void*>(pointee));
+			lua_pushvalue(L, index);
+			lua_rawset(L, -3);
+			lua_pop(L, 2);
+		}
+
+		namespace
+		{
+
+			// Instance userdata hold an object_rep followed by a pointer to this
+			// tag. Together with the userdata size it tells luabind instances
+			// apart from other userdata without looking at their metatable.
+			char const instance_tag = 0;
+
+			void const*& instance_tag_of(void* storage)
+			{
+				return *reinterpret_cast<void const**>(static_cast<char*>(storage) + sizeof(object_rep));
+			}
+
+		} // namespace unnamed
+
+		int destroy_instance(lua_State* L)
+		{
+			object_rep* instance = static_cast<object_rep*>(lua_touserdata(L, 1));
+
+			if(instance->crep()->may_have_finalizer() || instance->has_own_members())
+			{
+				lua_pushstring(L, "__finalize");
+				lua_gettable(L, 1);
+
+				if(lua_isnil(L, -1))
+				{
+					lua_pop(L, 1);
+				}
+				else
+				{
+					lua_pushvalue(L, 1);
+					lua_call(L, 1, 0);
+				}
+			}
+
+			class_rep* cls = instance->crep();
+
+			if(cls->has_identity_map() && instance->get_holder())
+				cls->remove_identity(L, instance->get_holder()->dynamic_pointer(), 1);
 
 			instance->~object_rep();
+			instance_tag_of(instance) = 0;
 
 			lua_pushnil(L);
 			lua_setmetatable(L, 1);
@@ -90,9 +194,86 @@ namespace luabind {
 		namespace
 		{
 
+			// User value 1 of an instance is its member table, the class table
+			// until it gets fields of its own. Instances of classes with slots
+			// keep the slot values in the following ones. Before Lua 5.4 a
+			// userdata has a single user value, so they are held in an array.
+			void get_user_value(lua_State* L, int index, int n, bool slotted)
+			{
+#if LUA_VERSION_NUM >= 504
+				lua_getiuservalue(L, index, n);
+#else
+				lua_getuservalue(L, index);
+
+				if(slotted)
+				{
+					lua_rawgeti(L, -1, n);
+					lua_replace(L, -2);
+				}
+#endif
+			}
+
+			// pops the value on top of the stack
+			void set_user_value(lua_State* L, int index, int n, bool slotted)
+			{
+#if LUA_VERSION_NUM >= 504
+				lua_setiuservalue(L, index, n);
+#else
+				if(slotted)
+				{
+					lua_getuservalue(L, index);
+					lua_insert(L, -2);
+					lua_rawseti(L, -2, n);
+					lua_pop(L, 1);
+				}
+				else
+				{
+					lua_setuservalue(L, index);
+				}
+#endif
+			}
+
+			// pushes the index of the slot named by the key at index 2,
+			// returns 0 if there is none
+			int find_slot(lua_State* L, class_rep* cls)
+			{
+				cls->get_slot_table(L);
+				lua_pushvalue(L, 2);
+				lua_rawget(L, -2);
+				int slot = static_cast<int>(lua_tointeger(L, -1));
+				lua_pop(L, 2);
+				return slot;
+			}
+
+			// returns the accessor of the property at the top of the stack,
+			// if it has one
+			member_accessor const* get_member_accessor(lua_State* L)
+			{
+				if(!lua_getupvalue(L, -1, 3))
+					return 0;
+
+				member_accessor const* accessor = static_cast<member_accessor const*>(lua_touserdata(L, -1));
+				lua_pop(L, 1);
+				return accessor;
+			}
+
 			int set_instance_value(lua_State* L)
 			{
-				lua_getuservalue(L, 1);
+				object_rep* instance = static_cast<object_rep*>(lua_touserdata(L, 1));
+				class_rep* cls = instance->crep();
+				bool const slotted = cls->slot_count() != 0;
+
+				if(slotted)
+				{
+					if(int slot = find_slot(L, cls))
+					{
+						lua_pushvalue(L, 3);
+						set_user_value(L, 1, slot + 1, true);
+						return 0;
+					}
+				}
+
+				get_user_value(L, 1, 1, slotted);
 				lua_pushvalue(L, 2);
 				lua_rawget(L, -2);
 
@@ -115,6 +296,18 @@ namespace luabind {
 						lua_error(L);
 					}
 
+					lua_insert(L, -2);
+
+					if(member_accessor const* accessor = get_member_accessor(L))
+					{
+						void* self = instance->is_const() ? 0 : instance->get_instance(accessor->id).first;
+
+						if(self && accessor->set(L, *accessor, self, 3))
+							return 0;
+					}
+
+					lua_pop(L, 1);
+
 					lua_pushvalue(L, 1);
 					lua_pushvalue(L, 3);
 					lua_call(L, 2, 0);
@@ -127,9 +320,15 @@ namespace luabind {
 				{
 					lua_newtable(L);
 					lua_pushvalue(L, -1);
-					lua_setuservalue(L, 1);
+					set_user_value(L, 1, 1, slotted);
 					lua_pushvalue(L, 4);
 					lua_setmetatable(L, -2);
+					instance->set_own_members();
+
+					// The class metatable may look members up in the class
+					// table only, which would hide the new instance table.
+					lua_rawgeti(L, LUA_REGISTRYINDEX, class_registry::get_registry(L)->cpp_instance());
+					lua_setmetatable(L, 1);
 				}
 				else
 				{
@@ -145,7 +344,23 @@ namespace luabind {
 
 			int get_instance_value(lua_State* L)
 			{
-				lua_getuservalue(L, 1);
+				class_rep* cls = static_cast<object_rep*>(lua_touserdata(L, 1))->crep();
+				bool const slotted = cls->slot_count() != 0;
+
+				if(slotted)
+				{
+					if(int slot = find_slot(L, cls))
+					{
+						get_user_value(L, 1, slot + 1, true);
+
+						if(!lua_isnil(L, -1))
+							return 1;
+
+						lua_pop(L, 1);
+					}
+				}
+
+				get_user_value(L, 1, 1, slotted);
 				lua_pushvalue(L, 2);
 				lua_rawget(L, -2);
 
@@ -157,6 +372,15 @@ namespace luabind {
 
 				if(lua_tocfunction(L, -1) == &property_tag)
 				{
+					if(member_accessor const* accessor = get_member_accessor(L))
+					{
+						if(void* self = static_cast<object_rep*>(lua_touserdata(L, 1))->get_instance(accessor->id).first)
+						{
+							accessor->get(L, *accessor, self);
+							return 1;
+						}
+					}
+
 					// this member is a property, extract the "get" function and call it.
 					lua_getupvalue(L, -1, 1);
 					lua_pushvalue(L, 1);
@@ -170,8 +394,35 @@ namespace luabind {
 			{
 				for(int i = 0; i < 2; ++i)
 				{
-					if(get_instance(L, 1 + i))
+					if(object_rep* instance = get_instance(L, 1 + i))
 					{
+						class_rep* cls = instance->crep();
+						int const id = static_cast<int>(lua_tointeger(L, lua_upvalueindex(3)));
+
+						// Operators bound from C++ are called without going
+						// through the instance's __index and a Lua call.
+						if(function_object* f = cls->operator_function(L, id))
+						{
+							// members of the instance itself may replace them
+							if(!instance->has_own_members())
+							{
+								if(lua_toboolean(L, lua_upvalueindex(2))) // remove trailing nil
+									lua_settop(L, 1);
+
+								int results;
+
+								if(!call_function_object(L, f, results))
+									lua_error(L);
+
+								if(results == 0)
+									lua_pushnil(L);
+								else
+									lua_settop(L, lua_gettop(L) - results + 1);
+
+								return 1;
+							}
+						}
+
 						int nargs = lua_gettop(L);
 
 						lua_pushvalue(L, lua_upvalueindex(1));
@@ -204,16 +455,47 @@ namespace luabind {
 
 		} // namespace unnamed
 
+		LUABIND_API bool has_own_member(lua_State* L, char const* name)
+		{
+			int const index = lua_gettop(L);
+			object_rep* instance = static_cast<object_rep*>(lua_touserdata(L, index));
+			class_rep* cls = instance->crep();
+			bool const slotted = cls->slot_count() != 0;
+
+			if(slotted)
+			{
+				cls->get_slot_table(L);
+				lua_pushstring(L, name);
+				lua_rawget(L, -2);
+				int const slot = static_cast<int>(lua_tointeger(L, -1));
+				lua_pop(L, 2);
+
+				if(slot)
+				{
+					get_user_value(L, index, slot + 1, true);
+					bool const found = !lua_isnil(L, -1);
+					lua_pop(L, 1);
+
+					if(found)
+						return true;
+				}
+			}
+
+			if(!instance->has_own_members())
+				return false;
+
+			get_user_value(L, index, 1, slotted);
+			lua_pushstring(L, name);
+			lua_rawget(L, -2);
+			bool const found = !lua_isnil(L, -1);
+			lua_pop(L, 2);
+			return found;
+		}
+
 		LUABIND_API void push_instance_metatable(lua_State* L)
 		{
 			lua_newtable(L);
 
-			// This is used as a tag to determine if a userdata is a luabind
-			// instance. We use a numeric key and a cclosure for fast comparison.
-			lua_pushnumber(L, 1);
-			lua_pushcclosure(L, get_instance_value, 0);
-			lua_rawset(L, -3);
-
 			lua_pushcclosure(L, destroy_instance, 0);
 			lua_setfield(L, -2, "__gc");
 
@@ -228,35 +510,43 @@ namespace luabind {
 				lua_pushstring(L, get_operator_name(op));
 				lua_pushvalue(L, -1);
 				lua_pushboolean(L, op == op_unm || op == op_len);
-				lua_pushcclosure(L, &dispatch_operator, 2);
+				lua_pushinteger(L, op);
+				lua_pushcclosure(L, &dispatch_operator, 3);
 				lua_settable(L, -3);
 			}
 		}
 
 		LUABIND_API object_rep* get_instance(lua_State* L, int index)
 		{
-			object_rep* result = static_cast<object_rep*>(lua_touserdata(L, index));
+			void* storage = lua_touserdata(L, index);
 
-			if(!result || !lua_getmetatable(L, index))
+			// Light userdata have no size, so they are rejected here as well.
+			if(!storage || lua_rawlen(L, index) < instance_buffer_offset || instance_tag_of(storage) != &instance_tag)
 				return 0;
 
-			lua_rawgeti(L, -1, 1);
-
-			if(lua_tocfunction(L, -1) != &get_instance_value)
-				result = 0;
-
-			lua_pop(L, 2);
-
-			return result;
+			return static_cast<object_rep*>(storage);
 		}
 
-		LUABIND_API object_rep* push_new_instance(lua_State* L, class_rep* cls)
+		LUABIND_API object_rep* push_new_instance(lua_State* L, class_rep* cls, std::size_t holder_size)
 		{
-			void* storage = lua_newuserdata(L, sizeof(object_rep));
-			object_rep* result = new (storage) object_rep(0, cls);
+#if LUA_VERSION_NUM >= 504
+			void* storage = lua_newuserdatauv(L, instance_buffer_offset + holder_size, 1 + cls->slot_count());
+#else
+			void* storage = lua_newuserdata(L, instance_buffer_offset + holder_size);
+#endif
+			object_rep* result = new (storage) object_rep(0, cls, holder_size);
+			instance_tag_of(storage) = &instance_tag;
 			cls->get_table(L);
+#if LUA_VERSION_NUM < 504
+			if(cls->slot_count())
+			{
+				lua_createtable(L, 1 + cls->slot_count(), 0);
+				lua_insert(L, -2);
+				lua_rawseti(L, -2, 1);
+			}
+#endif
 			lua_setuservalue(L, -2);
-			lua_rawgeti(L, LUA_REGISTRYINDEX, cls->metatable_ref());
+			cls->get_instance_metatable(L);
 			lua_setmetatable(L, -2);
 			return result;
 		}
@@ -29,6 +29,7 @@
 #include <luabind/set_package_preload.hpp>
 #include <luabind/function_introspection.hpp>
 #include <luabind/detail/garbage_collector.hpp>
+#include <luabind/detail/state_context.hpp>
 
 namespace luabind {
 
@@ -53,6 +54,7 @@ namespace luabind {
 		}
 
 		int main_thread_tag;
+		int state_context_tag;
 
 		int deprecated_super(lua_State* L)
 		{
@@ -81,36 +83,40 @@ namespace luabind {
 		return result;
 	}
 
+	namespace detail {
+
+		LUABIND_API state_context& get_state_context(lua_State* L)
+		{
+			lua_pushlightuserdata(L, &state_context_tag);
+			lua_rawget(L, LUA_REGISTRYINDEX);
+			state_context* result = static_cast<state_context*>(lua_touserdata(L, -1));
+			lua_pop(L, 1);
+
+			if(!result)
+				throw std::runtime_error("Unable to get luabind state, luabind::open() not called?");
+
+			return *result;
+		}
+
+	} // namespace detail
+
 	namespace {
 
-		template<typename T>
-		inline void * shared_create_userdata(lua_State* L, const char * name) {
-			lua_pushstring(L, name);
-			void* storage = lua_newuserdata(L, sizeof(T));
+		void create_state_context(lua_State* L)
+		{
+			lua_pushlightuserdata(L, &state_context_tag);
+			void* storage = lua_newuserdata(L, sizeof(detail::state_context));
 
 			// set gc metatable
 			lua_newtable(L);
-			lua_pushcclosure(L, &detail::garbage_collector<T>, 0);
+			lua_pushcclosure(L, &detail::garbage_collector<detail::state_context>, 0);
 			lua_setfield(L, -2, "__gc");
 			lua_setmetatable(L, -2);
 
-			lua_settable(L, LUA_REGISTRYINDEX);
-			return storage;
-		}
-
-		template<typename T>
-		inline void createGarbageCollectedRegistryUserdata(lua_State* L, const char * name) {
-			void * storage = shared_create_userdata<T>(L, name);
 			// placement "new"
-			new (storage) T;
-		}
-
-		template<typename T, typename A1>
-		inline void createGarbageCollectedRegistryUserdata(lua_State* L, const char * name, A1 constructorArg) {
-			void * storage = shared_create_userdata<T>(L, name);
+			new (storage) detail::state_context(L);
 
-			// placement "new"
-			new (storage) T(constructorArg);
+			lua_rawset(L, LUA_REGISTRYINDEX);
 		}
 
 	}	// namespace anonymous
@@ -128,10 +134,7 @@ namespace luabind {
 			);
 		}
 
-		createGarbageCollectedRegistryUserdata<detail::class_registry>(L, "__luabind_classes", L);
-		createGarbageCollectedRegistryUserdata<detail::class_id_map>(L, "__luabind_class_id_map");
-		createGarbageCollectedRegistryUserdata<detail::cast_graph>(L, "__luabind_cast_graph");
-		createGarbageCollectedRegistryUserdata<detail::class_map>(L, "__luabind_class_map");
+		create_state_context(L);
 
 		// add functions (class, cast etc...)
 		lua_pushcclosure(L, detail::create_class::stage1, 0);
@@ -37,6 +37,16 @@ namespace luabind {
 			object_rep* obj = static_cast<object_rep*>(lua_touserdata(L, -1));
 			assert(obj);
 
+			if(!has_own_member(L, name))
+			{
+				if(class_rep::member_override const* entry = obj->crep()->find_member_override(L, name))
+				{
+					lua_pop(L, 1);
+					entry->function.push(L);
+					return;
+				}
+			}
+
 			lua_pushstring(L, name);
 			lua_gettable(L, -2);
 			lua_replace(L, -2);
@@ -52,6 +62,27 @@ namespace luabind {
 			lua_gettable(L, -2);
 			lua_remove(L, -2); // remove the crep table
 		}
+
+		LUABIND_API bool is_member_overridden(lua_State* L, char const* name)
+		{
+			object_rep* obj = static_cast<object_rep*>(lua_touserdata(L, -1));
+			assert(obj);
+
+			if(!has_own_member(L, name))
+			{
+				if(class_rep::member_override const* entry = obj->crep()->find_member_override(L, name))
+				{
+					lua_pop(L, 1);
+					return entry->overridden;
+				}
+			}
+
+			lua_pushstring(L, name);
+			lua_gettable(L, -2);
+			bool const overridden = !lua_isnil(L, -1) && !is_luabind_function(L, -1);
+			lua_pop(L, 2);
+			return overridden;
+		}
 	}
 }
 
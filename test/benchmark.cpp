@@ -1,5 +1,7 @@
 #include <iostream>
 #include <ctime>
+#include <algorithm>
+#include <utility>
 
 namespace std
 {
@@ -18,6 +20,7 @@ extern "C"
 }
 
 #include <luabind/luabind.hpp>
+#include <luabind/detail/class_registry.hpp>
 
 struct A {};
 
@@ -33,6 +36,32 @@ int f2(lua_State* L)
 	return 0;
 }
 
+// functions taking 1-4 class arguments
+void g1(A*) {}
+void g2(A*, A*) {}
+void g3(A*, A*, A*) {}
+void g4(A*, A*, A*, A*) {}
+
+// types used to fill the type_id maps
+template <std::size_t N>
+struct many {};
+
+const std::size_t num_types = 1024;
+
+template <std::size_t... N>
+void make_types(luabind::type_id* types, std::index_sequence<N...>)
+{
+	luabind::type_id all[] = { typeid(many<N>)... };
+	std::copy(all, all + sizeof...(N), types);
+}
+
+std::clock_t time_string(lua_State* L, char const* str)
+{
+	std::clock_t start = std::clock();
+	luaL_dostring(L, str);
+	return std::clock() - start;
+}
+
 
 int main()
 {
@@ -48,7 +77,11 @@ int main()
     [
         class_<A>("A")
             .def(constructor<>()),
-        def("test1", &f1)
+        def("test1", &f1),
+        def("g1", &g1),
+        def("g2", &g2),
+        def("g3", &g3),
+        def("g4", &g4)
     ];	
 
 	lua_pushcclosure(L, &f2, 0);
@@ -56,6 +89,7 @@ int main()
 
 	std::clock_t total1 = 0;
 	std::clock_t total2 = 0;
+	std::clock_t class_args[4] = { 0, 0, 0, 0 };
 
 	for (int i = 0; i < loops; ++i)
 	{
@@ -79,6 +113,24 @@ int main()
 		std::clock_t end2 = std::clock();
 		total1 += end1 - start1;
 		total2 += end2 - start2;
+
+		// benchmark passing class instances
+		class_args[0] += time_string(L, "a = A()\n"
+									"for i = 1, 100000 do\n"
+										"g1(a)\n"
+									"end");
+		class_args[1] += time_string(L, "a = A()\n"
+									"for i = 1, 100000 do\n"
+										"g2(a, a)\n"
+									"end");
+		class_args[2] += time_string(L, "a = A()\n"
+									"for i = 1, 100000 do\n"
+										"g3(a, a, a)\n"
+									"end");
+		class_args[3] += time_string(L, "a = A()\n"
+									"for i = 1, 100000 do\n"
+										"g4(a, a, a, a)\n"
+									"end");
 	}
 
 
@@ -92,6 +144,48 @@ int main()
 		<< "empty:\t" << time2 * 1000000 / num_calls / loops << " microseconds per call\n"
 		<< "diff:\t" << ((time1 - time2) * 1000000 / num_calls / loops) << " microseconds\n\n";
 
+	for (int i = 0; i < 4; ++i)
+	{
+		double time = double(class_args[i]) / (double)CLOCKS_PER_SEC;
+		std::cout << (i + 1) << " class arguments:\t" << time * 1000000 / num_calls / loops << " microseconds per call\n";
+	}
+
+	// benchmark type_id lookups with many registered classes
+	{
+		static luabind::type_id types[num_types];
+		make_types(types, std::make_index_sequence<num_types>());
+
+		detail::class_id_map class_ids;
+		detail::class_registry* registry = detail::class_registry::get_registry(L);
+
+		for (std::size_t i = 0; i < num_types; ++i)
+		{
+			class_ids.put(i, types[i]);
+			registry->add_class(types[i], 0);
+		}
+
+		const int num_lookups = 1000000;
+		std::size_t sink = 0;
+
+		std::clock_t start = std::clock();
+		for (int i = 0; i < num_lookups; ++i)
+			sink += class_ids.get_local(types[i % num_types]);
+		std::clock_t ids_time = std::clock() - start;
+
+		start = std::clock();
+		for (int i = 0; i < num_lookups; ++i)
+			sink += registry->find_class(types[i % num_types]) ? 1 : 0;
+		std::clock_t registry_time = std::clock() - start;
+
+		std::cout << "\n" << num_types << " classes, class id lookup:\t"
+			<< double(ids_time) / CLOCKS_PER_SEC * 1000000000 / num_lookups << " nanoseconds\n"
+			<< num_types << " classes, class_rep lookup:\t"
+			<< double(registry_time) / CLOCKS_PER_SEC * 1000000000 / num_lookups << " nanoseconds\n";
+
+		if (sink == 0)
+			std::cout << "";
+	}
+
 	lua_close(L);
 }
 
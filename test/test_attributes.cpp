@@ -67,6 +67,49 @@ struct property_test : counted_type<property_test>
 
 COUNTER_GUARD(property_test);
 
+enum field_enum { enum_a = 1, enum_b = 2 };
+
+struct fields
+{
+	fields() : i(1), d(0.5), flag(true), e(enum_a), u(3), ci(4), k(0) {}
+
+	void set_i(int v) { i = v * 10; }
+
+	int i;
+	double d;
+	bool flag;
+	field_enum e;
+	unsigned char u;
+	int const ci;
+	int k;
+};
+
+struct derived_fields : fields
+{};
+
+struct transform : counted_type<transform>
+{
+	C pos;
+
+	C const& get_pos() const
+	{
+		return pos;
+	}
+};
+
+COUNTER_GUARD(transform);
+
+void set_fields_d(fields& f, double v)
+{
+	f.d = v * 2;
+}
+
+fields const* const_fields()
+{
+	static fields f;
+	return &f;
+}
+
 void free_setter(property_test& p, int a)
 { p.set(a); }
 
@@ -127,6 +170,68 @@ void test_main(lua_State* L)
                 "borrowed", &attribute_holder::borrowed, no_dependency())
     ];
 
+    module(L) [
+        class_<fields>("fields")
+            .def(constructor<>())
+            .def_readwrite("i", &fields::i)
+            .def_readwrite("d", &fields::d)
+            .def_readwrite("flag", &fields::flag)
+            .def_readwrite("e", &fields::e)
+            .def_readwrite("u", &fields::u)
+            .def_readonly("ci", &fields::ci)
+            .def_readonly("ro", &fields::i)
+            .property("si", &fields::i, &fields::set_i)
+            .property("sd", &fields::d, &set_fields_d)
+            .def_readonly("k", &fields::k)
+            .property("ik", &fields::i, &fields::k),
+
+        class_<derived_fields, fields>("derived_fields")
+            .def(constructor<>())
+            .def_readwrite("j", &fields::i),
+
+        def("const_fields", &const_fields),
+
+        class_<transform>("transform")
+            .def(constructor<>())
+            .def_readwrite("pos", &transform::pos, cached_reference())
+            .def("get_pos", &transform::get_pos, cached_reference())
+    ];
+
+    // Arithmetic, bool and enum members are accessed in place.
+    DOSTRING(L,
+        "f = fields()\n"
+        "assert(f.i == 1 and f.d == 0.5 and f.flag == true)\n"
+        "assert(f.e == 1 and f.u == 3 and f.ci == 4)\n"
+        "f.i, f.d, f.flag, f.e, f.u = 2, 1.5, false, 2, 255\n"
+        "assert(f.i == 2 and f.d == 1.5 and f.flag == false)\n"
+        "assert(f.e == 2 and f.u == 255 and f.ro == 2)\n"
+        "g = derived_fields()\n"
+        "g.i = 5\n"
+        "g.j = 6\n"
+        "assert(g.i == 6 and g.j == 6)\n");
+
+    DOSTRING(L,
+        "local ok, msg = pcall(function() f.ro = 1 end)\n"
+        "assert(not ok and msg:find('read only'))\n"
+        "ok, msg = pcall(function() f.i = 'x' end)\n"
+        "assert(not ok and msg:find('^No matching overload'))\n"
+        "ok, msg = pcall(function() f.flag = 1 end)\n"
+        "assert(not ok and f.flag == false)\n"
+        "local c = const_fields()\n"
+        "assert(c.i == 1)\n"
+        "ok, msg = pcall(function() c.i = 2 end)\n"
+        "assert(not ok and c.i == 1)\n");
+
+    // A member read with a setter function or another member written.
+    DOSTRING(L,
+        "local h = fields()\n"
+        "h.si = 3\n"
+        "assert(h.i == 30 and h.si == 30)\n"
+        "h.sd = 2\n"
+        "assert(h.d == 4 and h.sd == 4)\n"
+        "h.ik = 7\n"
+        "assert(h.k == 7 and h.i == 30 and h.ik == 30)\n");
+
 	DOSTRING(L, "test = property()\n");
 
 	DOSTRING(L,
@@ -199,5 +304,39 @@ void test_main(lua_State* L)
 
     TEST_CHECK(borrowed_attribute::count == 1);
     TEST_CHECK(attribute_holder::count == 0);
+
+    // Repeated access to a member returns the same instance, which keeps
+    // the object it is a part of alive.
+    DOSTRING(L,
+        "t = transform()\n"
+        "assert(rawequal(t.pos, t.pos))\n"
+        "t.pos.a = 1\n"
+        "t.pos.a = t.pos.a + 1\n"
+        "assert(t.pos.a == 2)\n"
+        "assert(rawequal(t:get_pos(), t:get_pos()))\n"
+        "assert(not rawequal(t:get_pos(), t.pos))\n"
+        "assert(not pcall(function() t:get_pos().a = 3 end))\n"
+        "u = transform()\n"
+        "assert(not rawequal(t.pos, u.pos))\n"
+        "p = t.pos\n"
+        "t = nil\n"
+        "collectgarbage()\n"
+        "collectgarbage()\n"
+        "assert(p.a == 2)\n");
+
+    TEST_CHECK(transform::count == 2);
+
+    DOSTRING(L,
+        "p = nil\n"
+        "collectgarbage()\n"
+        "collectgarbage()\n"
+        "p = u.pos\n"
+        "p.a = 4\n"
+        "p = nil\n"
+        "collectgarbage()\n"
+        "collectgarbage()\n"
+        "assert(u.pos.a == 4)\n");
+
+    TEST_CHECK(transform::count == 1);
 }
 
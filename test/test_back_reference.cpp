@@ -41,6 +41,32 @@ struct base1
 struct base_wrap1 : base1, wrap_base
 {};
 
+// only the derived class has a wrapper
+struct base2
+{
+    virtual ~base2() {}
+};
+
+struct base3 : base2
+{};
+
+struct base_wrap3 : base3, wrap_base
+{};
+
+// the wrapper is reached through an interface that isn't registered
+struct interface4
+{
+    virtual ~interface4() {}
+};
+
+struct base4
+{
+    virtual ~base4() {}
+};
+
+struct base_wrap4 : base4, interface4, wrap_base
+{};
+
 base0* filter0(base0* p)
 {
     return p;
@@ -51,6 +77,16 @@ std::shared_ptr<base1> filter1(std::shared_ptr<base1> const& p)
     return p;
 }
 
+base2* filter2(base2* p)
+{
+    return p;
+}
+
+interface4* as_interface4(base4* p)
+{
+    return dynamic_cast<interface4*>(p);
+}
+
 void test_main(lua_State* L)
 {
     module(L)
@@ -61,7 +97,17 @@ void test_main(lua_State* L)
 
 		class_<base1, no_bases, std::shared_ptr<base1>, base_wrap1 >("base1")
           .def(constructor<>()),
-        def("filter1", &filter1)
+        def("filter1", &filter1),
+
+        class_<base2>("base2"),
+
+        class_<base3, base2, default_holder, base_wrap3>("base3")
+          .def(constructor<>()),
+        def("filter2", &filter2),
+
+        class_<base4, no_bases, default_holder, base_wrap4>("base4")
+          .def(constructor<>()),
+        def("as_interface4", &as_interface4)
     ];
 
     DOSTRING(L,
@@ -87,5 +133,29 @@ void test_main(lua_State* L)
         "y = filter1(x)\n"
         "assert(x == y)\n"
     );
+
+    DOSTRING(L,
+        "class 'derived3' (base3)\n"
+        "  function derived3:__init()\n"
+        "    base3.__init(self)\n"
+        "  end\n"
+
+        "x = derived3()\n"
+        "y = filter2(x)\n"
+        "assert(x == y)\n"
+    );
+
+    DOSTRING(L,
+        "class 'derived4' (base4)\n"
+        "  function derived4:__init()\n"
+        "    base4.__init(self)\n"
+        "    self.field = 4\n"
+        "  end\n"
+
+        "x = derived4()\n"
+        "y = as_interface4(x)\n"
+        "assert(rawequal(x, y))\n"
+        "assert(y.field == 4)\n"
+    );
 }
 
@@ -22,6 +22,7 @@
 
 #include "test.hpp"
 #include <luabind/luabind.hpp>
+#include <luabind/adopt_policy.hpp>
 
 struct A : counted_type<A>
 {
@@ -34,6 +35,8 @@ struct A : counted_type<A>
 
 void f(A*, const A&) {}
 
+void adopt_a(A* a) { delete a; }
+
 struct B: A, counted_type<B>
 {
 	int test2;
@@ -60,12 +63,36 @@ struct deriv_2 : deriv_1, counted_type<deriv_2>
 	void doMore() {}
 };
 
+// Larger than the inline holder storage used to be, and over-aligned.
+struct alignas(32) big : counted_type<big>
+{
+	double values[12];
+
+	big() { values[11] = 11; }
+
+	bool aligned() const
+	{
+		return reinterpret_cast<std::size_t>(this) % 32 == 0;
+	}
+
+	double last() const
+	{
+		return values[11];
+	}
+};
+
+big make_big()
+{
+	return big();
+}
+
 COUNTER_GUARD(A);
 COUNTER_GUARD(B);
 COUNTER_GUARD(C);
 COUNTER_GUARD(base1);
 COUNTER_GUARD(deriv_1);
 COUNTER_GUARD(deriv_2);
+COUNTER_GUARD(big);
 
 void test_main(lua_State* L)
 {
@@ -85,7 +112,15 @@ void test_main(lua_State* L)
 			.def(constructor<>())
 			.def_readonly("test2", &B::test2),
 
-		class_<C>("C")
+		class_<C>("C"),
+
+		class_<big, no_bases, held_by_value>("big")
+			.def(constructor<>())
+			.def("aligned", &big::aligned)
+			.def("last", &big::last),
+
+		def("make_big", &make_big),
+		def("adopt_a", &adopt_a, adopt_policy<1>())
 
 	];
 
@@ -108,5 +143,31 @@ void test_main(lua_State* L)
 		"b2 = B()\n"
 		"assert(b2.test2 == 3)\n");
 	DOSTRING(L, "assert(b2.test == 2)");
+
+	DOSTRING(L,
+		"for i = 1, 4 do\n"
+		"  local x = make_big()\n"
+		"  assert(x:aligned())\n"
+		"  assert(x:last() == 11)\n"
+		"  local y = big()\n"
+		"  assert(y:aligned())\n"
+		"  assert(y:last() == 11)\n"
+		"end\n"
+		"collectgarbage()\n");
+
+	// Replacing __init from Lua must be seen by the next construction.
+	DOSTRING(L,
+		"local init = A.__init\n"
+		"A.__init = function(self, a) init(self, a * 2) end\n"
+		"assert(A(3).test == 6)\n"
+		"A.__init = init\n"
+		"assert(A(3).test == 3)\n");
+
+	DOSTRING_EXPECTED(L, "C()", "attempt to call a nil value");
+
+	// Objects created from Lua are held by pointer unless asked otherwise,
+	// C++ can take them over.
+	DOSTRING(L,
+		"adopt_a(A(4))\n");
 }
 
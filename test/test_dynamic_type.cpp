@@ -41,6 +41,27 @@ struct Unregistered : Base
     {}
 };
 
+struct Other
+{
+    virtual ~Other()
+    {}
+
+    int h() const
+    {
+        return 4;
+    }
+};
+
+struct OtherDerived : Other
+{};
+
+struct Late : Base, Other
+{
+    Late()
+      : Base(5)
+    {}
+};
+
 std::unique_ptr<Base> make_derived()
 {
     return std::unique_ptr<Base>(new Derived);
@@ -51,6 +72,22 @@ std::unique_ptr<Base> make_unregistered()
     return std::unique_ptr<Base>(new Unregistered);
 }
 
+std::unique_ptr<Base> make_late()
+{
+    return std::unique_ptr<Base>(new Late);
+}
+
+Other* late_as_other()
+{
+    static Late late;
+    return &late;
+}
+
+int get_other(Other const& x)
+{
+    return x.h();
+}
+
 void test_main(lua_State* L)
 {
     using namespace luabind;
@@ -61,7 +98,12 @@ void test_main(lua_State* L)
         class_<Derived, Base>("Derived")
             .def("f", &Derived::f),
         def("make_derived", &make_derived),
-        def("make_unregistered", &make_unregistered)
+        def("make_unregistered", &make_unregistered),
+        class_<Other>("Other"),
+        class_<OtherDerived, Other>("OtherDerived"),
+        def("make_late", &make_late),
+        def("get_other", &get_other),
+        def("late_as_other", &late_as_other)
     ];
 
     DOSTRING(L,
@@ -73,5 +115,30 @@ void test_main(lua_State* L)
         "x = make_unregistered()\n"
         "assert(x:g() == 3)\n"
     );
-}
 
+    // Registering a class must forget casts that were found impossible
+    // before it existed.
+    DOSTRING(L,
+        "y = make_late()\n"
+        "assert(not pcall(get_other, y))\n"
+    );
+
+    module(L) [
+        class_<Late, bases<Base, Other> >("Late")
+    ];
+
+    DOSTRING(L,
+        "assert(get_other(y) == 4)\n"
+    );
+
+    // Pushed through a base that does not start the object, repeatedly.
+    DOSTRING(L,
+        "for i = 1, 3 do\n"
+        "  local z = late_as_other()\n"
+        "  assert(z:g() == 5)\n"
+        "  assert(get_other(z) == 4)\n"
+        "  x = make_derived()\n"
+        "  assert(x:f() == 1)\n"
+        "end\n"
+    );
+}
@@ -118,6 +118,18 @@ void tester12(std::shared_ptr<derived> const& r)
 	if (r->n2 == 7) feedback = 12;
 }
 
+// Replaces the object held by an instance from C++.
+void reseat(std::shared_ptr<base>* t)
+{
+    t->reset(new base());
+    (*t)->n = 5;
+}
+
+int get_n(base const* b)
+{
+    return b->n;
+}
+
 derived tester13()
 {
     feedback = 13;
@@ -147,6 +159,8 @@ void test_main(lua_State* L)
 		def("tester11", &tester11),
 		def("tester12", &tester12),
 		def("tester13", &tester13),
+        def("reseat", &reseat),
+        def("get_n", &get_n),
 
         class_<base, no_bases, std::shared_ptr<base> >("base")
             .def(constructor<>())
@@ -199,5 +213,11 @@ void test_main(lua_State* L)
 
     DOSTRING(L, "tester13()");
     TEST_CHECK(feedback == 13);
+
+    DOSTRING(L,
+        "c = base()\n"
+        "assert(get_n(c) == 4)\n"
+        "reseat(c)\n"
+        "assert(get_n(c) == 5)\n");
 }
 
@@ -0,0 +1,67 @@
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test.hpp"
+#include <luabind/luabind.hpp>
+
+using namespace luabind;
+
+struct entity
+{
+	virtual ~entity() {}
+	int id = 1;
+};
+
+struct player : entity
+{};
+
+struct item
+{};
+
+player s_player;
+item s_item;
+
+entity* get_entity() { return &s_player; }
+player* get_player() { return &s_player; }
+entity const* get_const_entity() { return &s_player; }
+item* get_item() { return &s_item; }
+
+void test_main(lua_State* L)
+{
+	module(L)
+	[
+		class_<entity>("entity")
+			.identity_map()
+			.def_readwrite("id", &entity::id),
+
+		class_<player, entity>("player"),
+
+		class_<item>("item"),
+
+		def("get_entity", &get_entity),
+		def("get_player", &get_player),
+		def("get_const_entity", &get_const_entity),
+		def("get_item", &get_item)
+	];
+
+	// The same object gives the same instance, also through a base pointer.
+	DOSTRING(L,
+		"local tab = {}\n"
+		"tab[get_entity()] = 1\n"
+		"assert(rawequal(get_entity(), get_player()))\n"
+		"assert(tab[get_player()] == 1)\n"
+		"assert(not rawequal(get_entity(), get_const_entity()))\n"
+		"assert(get_const_entity().id == 1)");
+
+	// Classes without an identity map get a new instance every time.
+	DOSTRING(L,
+		"assert(not rawequal(get_item(), get_item()))");
+
+	// A new instance is made once the previous one is collected.
+	DOSTRING(L,
+		"collectgarbage()\n"
+		"collectgarbage()\n"
+		"get_entity().id = 2\n"
+		"assert(get_player().id == 2)");
+}
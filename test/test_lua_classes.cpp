@@ -123,6 +123,35 @@ struct base_wrap : base, wrap_base
 	}
 };
 
+struct D
+{
+	virtual ~D() {}
+	virtual int f() { return 1; }
+	virtual int g() { return 1; }
+};
+
+struct D_wrap : D, wrap_base
+{
+	int f() override
+	{
+		if(!is_overridden("f"))
+			return D::f();
+		return call<int>("f");
+	}
+
+	static int default_f(D* p) { return p->D::f(); }
+
+	int g() override
+	{
+		return call<int>("g");
+	}
+
+	static int default_g(D* p) { return p->D::g(); }
+};
+
+int call_f(D& d) { return d.f(); }
+int call_g(D& d) { return d.g(); }
+
 struct T_ // vc6.5, don't name your types T!
 {
 	int f(int) { return 1; }
@@ -155,6 +184,14 @@ void test_main(lua_State* L)
 			.def("f", &base::f, &base_wrap::default_f)
 			.def("g", &base::g),
 
+		class_<D, no_bases, default_holder, D_wrap>("D")
+			.def(constructor<>())
+			.def("f", &D::f, &D_wrap::default_f)
+			.def("g", &D::g, &D_wrap::default_g),
+
+		def("call_f", &call_f),
+		def("call_g", &call_g),
+
 		class_<T_>("T")
 			.def("f", &T_::f),
 
@@ -354,5 +391,35 @@ void test_main(lua_State* L)
 	DOSTRING(L,
 		"a = derived()\n"
 		"assert(a == filter(a))\n");
+
+	// finalizers, defined on the class or on the instance
+	DOSTRING(L,
+		"finalized = 0\n"
+		"class 'finalized_class'\n"
+		"function finalized_class:__init() end\n"
+		"local x = finalized_class()\n"
+		"function finalized_class:__finalize() finalized = finalized + 1 end\n"
+		"x = nil\n"
+		"local y = base()\n"
+		"y.__finalize = function() finalized = finalized + 10 end\n"
+		"y = nil\n"
+		"collectgarbage()\n"
+		"collectgarbage()\n"
+		"assert(finalized == 11)\n");
+
+	// overrides defined after the first call from C++
+	DOSTRING(L,
+		"class 'lua_D' (D)\n"
+		"function lua_D:__init() D.__init(self) end\n"
+		"local x = lua_D()\n"
+		"assert(call_f(x) == 1)\n"
+		"assert(call_g(x) == 1)\n"
+		"function lua_D:f() return 2 end\n"
+		"function lua_D:g() return 2 end\n"
+		"assert(call_f(x) == 2)\n"
+		"assert(call_g(x) == 2)\n"
+		"x.g = function() return 3 end\n"
+		"assert(call_g(x) == 3)\n"
+		"assert(call_g(lua_D()) == 2)\n");
 }
 
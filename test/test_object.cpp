@@ -302,6 +302,25 @@ void test_main(lua_State* L)
 	TEST_CHECK(object_cast<test_param const*>(globals(L)["temp"]) == &temp_object);
 	TEST_CHECK(globals(L)["temp"] == temp_object);
 
+	// copies share the registry entry, moves empty the source
+	{
+		object a(L, 1);
+		object b = a;
+		object c(std::move(b));
+		TEST_CHECK(!b.is_valid());
+		TEST_CHECK(a == c);
+		b = std::move(c);
+		TEST_CHECK(!c.is_valid());
+		TEST_CHECK(object_cast<int>(b) == 1);
+
+		DOSTRING(L, "iterated = { 1, 2 }");
+		iterator i(globals(L)["iterated"]);
+		iterator j = i;
+		++i;
+		TEST_CHECK(object_cast<int>(i.key()) == 2);
+		TEST_CHECK(object_cast<int>(j.key()) == 1);
+	}
+
 	// test the registry
 	object reg = registry(L);
 	reg["__a"] = "foobar";
@@ -219,5 +219,18 @@ void test_main(lua_State* L)
 	DOSTRING(L,
 		"x = len_tester(3)\n"
 		"assert(#x == 3)");
+
+	DOSTRING(L,
+		"local ok, msg = pcall(function() return test + 'x' end)\n"
+		"assert(not ok and msg:find('^No matching overload'))\n");
+
+	// Operators replaced on an instance or on the class after they were used.
+	DOSTRING(L,
+		"t = operator_tester()\n"
+		"t.__mul = function() return 1 end\n"
+		"assert(t * t == 1)\n"
+		"assert(test * test == 35)\n"
+		"operator_tester.__mod = function() return 2 end\n"
+		"assert(test % test == 2)\n");
 }
 
@@ -0,0 +1,242 @@
+// Use, modification and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test.hpp"
+#include <luabind/luabind.hpp>
+#include <luabind/adopt_policy.hpp>
+
+using namespace luabind;
+
+struct A
+{
+    virtual ~A() {}
+};
+
+struct B : A
+{};
+
+struct C : B
+{};
+
+A* make_b()
+{
+    return new B;
+}
+
+int f(int)
+{
+    return 1;
+}
+
+int f(std::string const&)
+{
+    return 2;
+}
+
+int f(A*)
+{
+    return 3;
+}
+
+int f(B*)
+{
+    return 4;
+}
+
+int f(A const*, int)
+{
+    return 5;
+}
+
+int f(B const*, int)
+{
+    return 6;
+}
+
+struct X
+{
+    int m(int) { return 1; }
+    int m(bool) { return 2; }
+    int m(char const*) { return 3; }
+    int m(A const&) { return 4; }
+    int m(int, int) { return 5; }
+    int m(int, std::string const&) { return 6; }
+    int m(object const&, A*) { return 7; }
+};
+
+int n(int)
+{
+    return 1;
+}
+
+int n(double)
+{
+    return 2;
+}
+
+template <int N>
+int amb(object const&)
+{
+    return N;
+}
+
+int g(int)
+{
+    return 1;
+}
+
+int g2(std::string const&)
+{
+    return 2;
+}
+
+int h(A*)
+{
+    return 1;
+}
+
+int h(B*)
+{
+    return 2;
+}
+
+void test_main(lua_State* L)
+{
+    module(L) [
+        class_<A>("A")
+            .def(constructor<>()),
+
+        class_<B, A>("B")
+            .def(constructor<>()),
+
+        class_<C, B>("C")
+            .def(constructor<>()),
+
+        def("make_b", &make_b, adopt_policy<0>()),
+
+        def("f", (int(*)(int))&f),
+        def("f", (int(*)(std::string const&))&f),
+        def("f", (int(*)(A*))&f),
+        def("f", (int(*)(B*))&f),
+        def("f", (int(*)(A const*, int))&f),
+        def("f", (int(*)(B const*, int))&f),
+
+        class_<X>("X")
+            .def(constructor<>())
+            .def("m", (int(X::*)(int))&X::m)
+            .def("m", (int(X::*)(bool))&X::m)
+            .def("m", (int(X::*)(char const*))&X::m)
+            .def("m", (int(X::*)(A const&))&X::m)
+            .def("m", (int(X::*)(int, int))&X::m)
+            .def("m", (int(X::*)(int, std::string const&))&X::m)
+            .def("m", (int(X::*)(object const&, A*))&X::m),
+
+        def("n", (int(*)(int))&n),
+        def("n", (int(*)(double))&n),
+
+        def("amb", &amb<0>),
+        def("amb", &amb<1>),
+        def("amb", &amb<2>),
+        def("amb", &amb<3>),
+        def("amb", &amb<4>),
+        def("amb", &amb<5>),
+        def("amb", &amb<6>),
+        def("amb", &amb<7>),
+        def("amb", &amb<8>),
+        def("amb", &amb<9>),
+        def("amb", &amb<10>),
+        def("amb", &amb<11>),
+
+        def("g", &g),
+
+        def("h", (int(*)(A*))&h)
+    ];
+
+    // Repeated calls must resolve the same way every time, even when calls
+    // with different argument shapes are interleaved.
+    DOSTRING(L,
+        "a = A()\n"
+        "b = B()\n"
+        "c = C()\n"
+        "for i = 1, 3 do\n"
+        "  assert(f(1) == 1)\n"
+        "  assert(f('x') == 2)\n"
+        "  assert(f(a) == 3)\n"
+        "  assert(f(b) == 4)\n"
+        "  assert(f(c) == 4)\n"
+        "  assert(f(make_b()) == 3)\n"
+        "  assert(f(a, 1) == 5)\n"
+        "  assert(f(c, 1) == 6)\n"
+        "end\n"
+    );
+
+    DOSTRING_EXPECTED(L,
+        "f(true)",
+        "No matching overload found, candidates:\n"
+        "int f(B const*,int)\n"
+        "int f(A const*,int)\n"
+        "int f(B*)\n"
+        "int f(A*)\n"
+        "int f(std::string const&)\n"
+        "int f(int)"
+    );
+
+    // Overloads told apart by the type of an argument other than the first.
+    DOSTRING(L,
+        "x = X()\n"
+        "for i = 1, 2 do\n"
+        "  assert(x:m(1) == 1)\n"
+        "  assert(x:m(false) == 2)\n"
+        "  assert(x:m('x') == 3)\n"
+        "  assert(x:m(nil) == 3)\n"
+        "  assert(x:m(c) == 4)\n"
+        "  assert(x:m(1, 2) == 5)\n"
+        "  assert(x:m(1, 'x') == 6)\n"
+        "  assert(x:m('x', b) == 7)\n"
+        "  assert(x:m(1, nil) == 7)\n"
+        "end\n"
+    );
+
+    DOSTRING(L,
+        "assert(not pcall(function() x:m({}) end))\n"
+        "assert(not pcall(function() x:m(1, 2, 3) end))\n"
+    );
+
+    // Perfect matches that tie are still ambiguous.
+    DOSTRING(L,
+        "local ok, msg = pcall(n, 1)\n"
+        "assert(not ok)\n"
+        "assert(msg:find('^Ambiguous'))\n"
+        "local _, count = msg:gsub('int n', '')\n"
+        "assert(count == 2)\n"
+    );
+
+    // More ties than fit in invoke_context's inline buffer.
+    DOSTRING(L,
+        "local ok, msg = pcall(amb, 1)\n"
+        "assert(not ok)\n"
+        "assert(msg:find('^Ambiguous'))\n"
+        "local _, count = msg:gsub('int amb', '')\n"
+        "assert(count == 12)\n"
+    );
+
+    DOSTRING(L,
+        "assert(h(a) == 1)\n"
+        "assert(h(b) == 1)\n"
+    );
+
+    // Adding an overload must invalidate what was learned about the chain.
+    module(L) [
+        def("g", &g2),
+        def("h", (int(*)(B*))&h)
+    ];
+
+    DOSTRING(L,
+        "assert(g(1) == 1)\n"
+        "assert(g('x') == 2)\n"
+        "assert(h(a) == 1)\n"
+        "assert(h(b) == 2)\n"
+        "assert(h(c) == 2)\n"
+    );
+}
@@ -46,6 +46,9 @@ struct test_class2 : counted_type<test_class2>
 	{ return 1; }
 };
 
+struct test_class3 : test_class
+{};
+
 COUNTER_GUARD(test_class);
 COUNTER_GUARD(test_class2);
 
@@ -76,6 +79,12 @@ void test_main(lua_State* L)
 				value("val2", 2)
 			],
 
+		class_<test_class3, test_class>("test_class3")
+			.enum_("vals")
+			[
+				value("val3", 3)
+			],
+
 		def("f", &f),
 		def("f", &f_),
 
@@ -111,6 +120,15 @@ void test_main(lua_State* L)
     DOSTRING(L,
 		"b = test.test_class.val2\n"
 		"assert(b == 2)");
+	DOSTRING(L,
+		"assert(test.test_class3.val1 == 1)\n"
+		"assert(test.test_class3.val3 == 3)");
+	DOSTRING_EXPECTED(L,
+		"x = test.test_class.val3",
+		"no static 'val3' in class 'test_class'");
+	DOSTRING(L,
+		"class 'lua_class' (test.test_class)\n"
+		"assert(lua_class.val2 == 2)");
 	DOSTRING(L, "assert(test.inner.g() == 4)");
 	DOSTRING(L, "assert(test.inner.g(7) == 5)");
 	DOSTRING(L, "assert(test.inner.f(4) == 3)");
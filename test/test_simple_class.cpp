@@ -49,6 +49,14 @@ struct simple_class : counted_type<simple_class>
 };
 
 int simple_class::feedback = 0;
+
+struct slotted
+{
+	int f() const { return 1; }
+};
+
+struct slotted_derived : slotted
+{};
 	
 COUNTER_GUARD(simple_class);
 
@@ -67,7 +75,17 @@ void test_main(lua_State* L)
 			.def("f", (f_overload1)&simple_class::f)
 			.def("f", (f_overload2)&simple_class::f)
 			.def("f", (f_overload3)&simple_class::f)
-			.def("g", &simple_class::g)
+			.def("g", &simple_class::g),
+
+        class_<slotted>("slotted")
+            .def(constructor<>())
+            .def("f", &slotted::f)
+            .def_slot("x")
+            .def_slot("f"),
+
+        class_<slotted_derived, slotted>("slotted_derived")
+            .def(constructor<>())
+            .def_slot("y")
     ];
 
     DOSTRING(L,
@@ -100,5 +118,52 @@ void test_main(lua_State* L)
 
     DOSTRING(L, "if a:g() == \"foo\\0bar\" then a:f() end");
     TEST_CHECK(simple_class::feedback == 1);
+
+    // Userdata that are not luabind instances must not be taken as one.
+    DOSTRING(L,
+        "assert(not pcall(a.f, io.stdout))\n"
+        "assert(not pcall(a.f, newproxy and newproxy() or io.stderr))\n");
+
+    // Members added to the class after instances exist, including
+    // properties and fields stored on a single instance.
+    DOSTRING(L,
+        "class 'plain'\n"
+        "  function plain:__init() end\n"
+        "p = plain()\n"
+        "q = plain()\n"
+        "function plain:m() return 1 end\n"
+        "assert(p:m() == 1)\n"
+        "plain.x = property(function() return 2 end)\n"
+        "assert(p.x == 2)\n"
+        "assert(plain().x == 2)\n"
+        "q.y = 3\n"
+        "assert(q.y == 3 and q.x == 2 and q:m() == 1)\n"
+        "assert(p.y == nil)\n");
+
+    // Declared slots, next to fields that were not declared.
+    DOSTRING(L,
+        "s = slotted()\n"
+        "t = slotted()\n"
+        "assert(s.x == nil)\n"
+        "assert(s:f() == 1)\n"
+        "s.x = 1\n"
+        "s.z = 2\n"
+        "s[1] = 3\n"
+        "assert(s.x == 1 and s.z == 2 and s[1] == 3)\n"
+        "assert(t.x == nil and t.z == nil and t[1] == nil)\n"
+        "s.f = 4\n"
+        "assert(s.f == 4 and t:f() == 1)\n"
+        "s.f = nil\n"
+        "assert(s:f() == 1)\n");
+
+    DOSTRING(L,
+        "class 'lua_slotted' (slotted_derived)\n"
+        "  function lua_slotted:__init() slotted_derived.__init(self) end\n"
+        "d = slotted_derived()\n"
+        "l = lua_slotted()\n"
+        "d.x, d.y = 1, 2\n"
+        "l.x, l.y = 3, 4\n"
+        "assert(d.x == 1 and d.y == 2 and l.x == 3 and l.y == 4)\n"
+        "assert(l:f() == 1)\n");
 }
 
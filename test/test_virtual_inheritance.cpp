@@ -178,6 +178,14 @@ void test_main(lua_State* L)
         "assert2(x:h() == 3)\n"
     );
 
+    // Offsets remembered for one object must hold for other objects of the
+    // same class.
+    DOSTRING(L,
+        "x2 = U(4)\n"
+        "assert2(x2:f() == 4)\n"
+        "assert2(x:f() == 1)\n"
+    );
+
     DOSTRING(L,
         "y = upcast(x)\n"
         "assert2(y:f() == 1)\n"